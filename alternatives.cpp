@@ -0,0 +1,318 @@
+#include "alternatives.h"
+#include "querycontext.h"
+#include "dijkstra.h"
+#include <set>
+#include <climits>
+#include <algorithm>
+#include <tuple>
+
+using namespace std;
+
+// Parâmetros dos filtros, em percentagem do tempo da rota principal
+static const int maxStretchPercent = 25;   // no máximo 25% mais lenta
+static const int maxSharedPercent = 80;    // no máximo 80% do tempo em comum
+static const int localWindowPercent = 25;  // janela do teste de otimalidade local
+
+// Método das penalidades
+static const int penaltyPercent = 30;      // cada uso torna o segmento 30% mais lento
+static const int penaltyRounds = 4;
+
+// Método dos plateaus
+static const int plateauCandidates = 8;
+
+// No máximo dois desvios (início, meio e fim de cada um) por candidato das penalidades
+static const size_t maxCheckpoints = 6;
+
+/**
+ * @brief Returns the shortest driving time of the arcs from one node to another, or -1 if none can be driven.
+ *
+ * @note Time Complexity: O(d), where d is the degree of `from`.
+ */
+static int segmentTime(GraphView gv, int from, int to) {
+    int best = -1;
+    for (int e = gv.firstEdge(from); e < gv.lastEdge(from); ++e) {
+        int w = gv.edgeData(e).drivingTime;
+        if (gv.target(e) == to && w != -1 && (best == -1 || w < best)) best = w;
+    }
+    return best;
+}
+
+/**
+ * @brief Computes the driving time from the start of a path to each of its nodes.
+ *
+ * @return False if a segment of the path cannot be driven.
+ *
+ * @note Time Complexity: O(n * d), where n is the number of nodes in the path and d the degree.
+ */
+static bool pathPrefix(GraphView gv, const vector<int>& path, vector<int>& prefix) {
+    prefix.assign(1, 0);
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        int w = segmentTime(gv, path[i], path[i + 1]);
+        if (w == -1) return false;
+        prefix.push_back(prefix.back() + w);
+    }
+    return true;
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm on driving times plus per-arc penalties, up to the destination.
+ *
+ * @note Time Complexity: O(E + V + P), where P is the largest penalized distance.
+ */
+static void penalizedSearch(GraphView gv, QueryContext& ctx, int s, int t, const vector<int>& penalty) {
+    static thread_local DefaultQueue pq;
+    pq.clear();
+    ctx.update(s, 0, -1);
+    pq.push(0, s);
+
+    while (!pq.empty()) {
+        int u = pq.pop().second;
+        if (ctx.isSettled(u)) continue;
+        ctx.settle(u);
+        if (u == t) return;
+
+        int du = ctx.distance(u);
+        for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+            int w = gv.edgeData(e).drivingTime;
+            if (w == -1) continue;
+            int v = gv.target(e);
+            int dv = du + w + penalty[e];
+            if (ctx.distance(v) > dv) {
+                ctx.update(v, dv, u);
+                pq.push(dv, v);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Generates alternative candidates with the penalty method.
+ *
+ * @param g The graph.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @param mainPath The shortest route.
+ * @param rounds The number of searches.
+ * @return The distinct candidates found, with their real driving times.
+ *
+ * @note Time Complexity: O(rounds * (E + V + P)), where P is the largest penalized distance.
+ */
+vector<AlternativeCandidate> penaltyAlternatives(const Graph& g, int s, int t, const vector<int>& mainPath, int rounds) {
+    GraphView gv = g.view();
+    int n = gv.nodeCount();
+    if (s < 0 || t < 0 || s >= n || t >= n || s == t || mainPath.size() < 2) return {};
+
+    // Penalidades por arco: reutilizadas entre consultas da mesma thread, limpas arco a arco
+    static thread_local vector<int> penalty;
+    if ((int)penalty.size() < gv.edgeCount()) penalty.assign(gv.edgeCount(), 0);
+    vector<int> touched;
+
+    auto penalize = [&](const vector<int>& path) {
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            // Os dois sentidos do segmento, e todos os arcos paralelos
+            for (int end : {path[i], path[i + 1]}) {
+                int other = end == path[i] ? path[i + 1] : path[i];
+                for (int e = gv.firstEdge(end); e < gv.lastEdge(end); ++e) {
+                    int w = gv.edgeData(e).drivingTime;
+                    if (gv.target(e) != other || w == -1) continue;
+                    if (penalty[e] == 0) touched.push_back(e);
+                    penalty[e] += max(1, w * penaltyPercent / 100);
+                }
+            }
+        }
+    };
+
+    set<pair<int, int>> mainSegments;
+    for (size_t i = 0; i + 1 < mainPath.size(); ++i) {
+        mainSegments.insert({mainPath[i], mainPath[i + 1]});
+        mainSegments.insert({mainPath[i + 1], mainPath[i]});
+    }
+
+    vector<AlternativeCandidate> candidates;
+    set<vector<int>> seen = {mainPath};
+    penalize(mainPath);
+
+    QueryContext& ctx = threadQueryContext();
+    for (int round = 0; round < rounds; ++round) {
+        ctx.prepare(n);
+        penalizedSearch(gv, ctx, s, t, penalty);
+        if (!ctx.isSettled(t)) break;
+
+        AlternativeCandidate c;
+        c.path = ctx.path(s, t);
+        penalize(c.path);
+        if (!seen.insert(c.path).second || !pathPrefix(gv, c.path, c.prefix)) continue;
+
+        // Desvios: troços fora da rota principal, de onde a deixa até onde volta a ela
+        for (size_t i = 0; i + 1 < c.path.size(); ++i) {
+            if (mainSegments.count({c.path[i], c.path[i + 1]})) continue;
+            size_t j = i + 1;
+            while (j + 1 < c.path.size() && !mainSegments.count({c.path[j], c.path[j + 1]})) ++j;
+            size_t middle = i;
+            while (middle < j && 2 * (c.prefix[middle] - c.prefix[i]) < c.prefix[j] - c.prefix[i]) ++middle;
+            c.checkpoints.insert(c.checkpoints.end(), {i, middle, j});
+            i = j - 1;
+        }
+        candidates.push_back(std::move(c));
+    }
+
+    for (int e : touched)
+        penalty[e] = 0;
+    return candidates;
+}
+
+/**
+ * @brief Generates alternative candidates with the plateau method.
+ *
+ * @param g The graph.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @param maxTime The longest driving time of interest.
+ * @param count The maximum number of candidates, longest plateaus first.
+ * @return The candidates.
+ *
+ * @note Time Complexity: O(E + V + D + c log c), where D is the largest distance and c the number of plateaus.
+ */
+vector<AlternativeCandidate> plateauAlternatives(const Graph& g, int s, int t, int maxTime, int count) {
+    GraphView gv = g.view();
+    int n = gv.nodeCount();
+    if (s < 0 || t < 0 || s >= n || t >= n || s == t) return {};
+
+    // Árvores de caminhos mais curtos a partir da origem e do destino (tempos simétricos)
+    QueryContext& fwd = threadQueryContext(0);
+    QueryContext& bwd = threadQueryContext(1);
+    fwd.prepare(n);
+    dijkstraSearch(gv, fwd, s, {});
+    if (!fwd.isSettled(t)) return {};
+    bwd.prepare(n);
+    dijkstraSearch(gv, bwd, t, {});
+
+    // O arco da árvore da origem que chega a v também está na árvore do destino
+    auto inBoth = [&](int v) {
+        int u = fwd.parentOf(v);
+        return u != -1 && bwd.parentOf(u) == v;
+    };
+
+    // Plateaus como (comprimento, último nó, primeiro nó); cada cadeia é percorrida uma vez, a partir do fim
+    vector<tuple<int, int, int>> plateaus;
+    for (int v = 0; v < n; ++v) {
+        if (!fwd.isSettled(v) || !bwd.isSettled(v) || !inBoth(v)) continue;
+        if ((long long)fwd.distance(v) + bwd.distance(v) > maxTime) continue;
+        int next = bwd.parentOf(v);
+        if (next != -1 && fwd.parentOf(next) == v) continue;   // o plateau continua
+
+        int first = v;
+        while (inBoth(first)) first = fwd.parentOf(first);
+        int length = fwd.distance(v) - fwd.distance(first);
+        if (length <= 0 || (first == s && v == t)) continue;   // vazio, ou a própria rota principal
+        plateaus.emplace_back(-length, v, first);
+    }
+    sort(plateaus.begin(), plateaus.end());
+    if ((int)plateaus.size() > count) plateaus.resize(count);
+
+    vector<AlternativeCandidate> candidates;
+    for (auto [negLength, last, first] : plateaus) {
+        AlternativeCandidate c;
+        c.path = fwd.path(s, last);
+        for (int v : c.path) {
+            if (v == first) c.checkpoints.push_back(c.prefix.size());
+            c.prefix.push_back(fwd.distance(v));
+        }
+        // Do fim do plateau até ao destino pela árvore do destino
+        for (int v = bwd.parentOf(last); v != -1; v = bwd.parentOf(v)) {
+            c.path.push_back(v);
+            c.prefix.push_back(fwd.distance(last) + bwd.distance(last) - bwd.distance(v));
+        }
+        candidates.push_back(std::move(c));
+    }
+    return candidates;
+}
+
+/**
+ * @brief Checks that the stretch of a candidate around one of its nodes is a shortest path.
+ *
+ * @param gv The read-only view of the graph.
+ * @param c The candidate.
+ * @param index The index of the node in the candidate.
+ * @param window The time covered on each side of the node.
+ * @return False if a faster route connects the ends of the stretch.
+ *
+ * @note Time Complexity: O(E + V + D), bounded by the time of the stretch.
+ */
+static bool locallyOptimal(GraphView gv, const AlternativeCandidate& c, size_t index, int window) {
+    size_t from = index, to = index;
+    while (from > 0 && c.prefix[index] - c.prefix[from] < window) --from;
+    while (to + 1 < c.path.size() && c.prefix[to] - c.prefix[index] < window) ++to;
+    if (from == to) return true;
+
+    // Só interessa se há um caminho mais curto do que o troço: a pesquisa para no seu tempo
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(gv.nodeCount());
+    dijkstraSearch(gv, ctx, c.path[from], {}, &EdgeData::drivingTime, c.path[to], c.prefix[to] - c.prefix[from]);
+    return !ctx.isSettled(c.path[to]);
+}
+
+/**
+ * @brief Picks the best alternative to a shortest route with the penalty and/or plateau method.
+ *
+ * @param g The graph.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @param mainPath The shortest route.
+ * @param strategy `Penalty`, `Plateau` or `Combined`.
+ * @return The alternative, or an empty vector if no candidate passes the filters.
+ *
+ * @note Time Complexity: O(E + V + D) times a constant number of searches.
+ */
+vector<int> filteredAlternativeRoute(const Graph& g, int s, int t, const vector<int>& mainPath,
+                                     AlternativeStrategy strategy) {
+    GraphView gv = g.view();
+    vector<int> mainPrefix;
+    if (mainPath.size() < 2 || !pathPrefix(gv, mainPath, mainPrefix)) return {};
+
+    long long best = mainPrefix.back();
+    int maxTime = (int)min<long long>(INT_MAX, best + best * maxStretchPercent / 100);
+    int window = (int)(best * localWindowPercent / 100);
+
+    vector<AlternativeCandidate> candidates;
+    if (strategy == AlternativeStrategy::Penalty || strategy == AlternativeStrategy::Combined)
+        candidates = penaltyAlternatives(g, s, t, mainPath, penaltyRounds);
+    if (strategy == AlternativeStrategy::Plateau || strategy == AlternativeStrategy::Combined) {
+        for (AlternativeCandidate& c : plateauAlternatives(g, s, t, maxTime, plateauCandidates))
+            candidates.push_back(std::move(c));
+    }
+
+    set<pair<int, int>> mainSegments;
+    for (size_t i = 0; i + 1 < mainPath.size(); ++i) {
+        mainSegments.insert({mainPath[i], mainPath[i + 1]});
+        mainSegments.insert({mainPath[i + 1], mainPath[i]});
+    }
+
+    // Filtros baratos primeiro; os candidatos que passam ficam ordenados por tempo + tempo em comum
+    vector<tuple<long long, vector<int>, size_t>> ranked;
+    for (size_t k = 0; k < candidates.size(); ++k) {
+        const AlternativeCandidate& c = candidates[k];
+        if (c.path == mainPath || c.time() > maxTime || c.checkpoints.size() > maxCheckpoints) continue;
+
+        set<int> nodes(c.path.begin(), c.path.end());
+        if (nodes.size() != c.path.size()) continue;   // tem um ciclo
+
+        long long shared = 0;
+        for (size_t i = 0; i + 1 < c.path.size(); ++i) {
+            if (mainSegments.count({c.path[i], c.path[i + 1]})) shared += c.prefix[i + 1] - c.prefix[i];
+        }
+        if (shared * 100 > best * maxSharedPercent) continue;
+        ranked.emplace_back(c.time() + shared, c.path, k);
+    }
+    sort(ranked.begin(), ranked.end());
+
+    // Teste de otimalidade local só até encontrar o melhor candidato que passa
+    for (const auto& [score, path, k] : ranked) {
+        const AlternativeCandidate& c = candidates[k];
+        bool optimal = true;
+        for (size_t i = 0; i < c.checkpoints.size() && optimal; ++i)
+            optimal = locallyOptimal(gv, c, c.checkpoints[i], window);
+        if (optimal) return c.path;
+    }
+    return {};
+}
@@ -0,0 +1,86 @@
+#ifndef ALTERNATIVES_HPP
+#define ALTERNATIVES_HPP
+
+#include <vector>
+#include "graph.h"
+#include "route.h"
+
+/**
+ * @struct AlternativeCandidate
+ * @brief A candidate alternative route, with the driving time from the source to each of its nodes.
+ */
+struct AlternativeCandidate {
+    std::vector<int> path;
+    std::vector<int> prefix;            // prefix[i]: tempo da origem até path[i]
+    std::vector<size_t> checkpoints;    // índices dos nós à volta dos quais se testa a otimalidade local
+
+    int time() const { return prefix.back(); }
+};
+
+/**
+ * @brief Generates alternative candidates with the penalty method.
+ *
+ * Every round is a shortest-path search in which the segments of the main route and of the
+ * candidates found so far are 30% slower per round they were used in (both directions), so
+ * each round is pushed away from the routes already known. The penalties live in a per-thread
+ * array that is cleared arc by arc after the query.
+ *
+ * @param g The graph.
+ * @param source The node ID of the starting location.
+ * @param dest The node ID of the destination location.
+ * @param mainPath The shortest route.
+ * @param rounds The number of searches.
+ * @return The distinct candidates found, with their real driving times (none equal to the main route);
+ *         the checkpoints are the first, middle and last node of every detour from the main route.
+ *
+ * @note Time Complexity: O(rounds * (E + V + P)), where P is the largest penalized distance.
+ */
+std::vector<AlternativeCandidate> penaltyAlternatives(const Graph& g, int source, int dest, const std::vector<int>& mainPath,
+    int rounds);
+
+/**
+ * @brief Generates alternative candidates with the plateau method.
+ *
+ * One search from the source and one from the destination (the graph is symmetric) give two
+ * shortest-path trees. A plateau is a chain of segments that belongs to both: the route
+ * through it follows the forward tree up to its end and the backward tree from there, and a
+ * long plateau means a long stretch of that route is optimal in both directions. The main
+ * route is itself a plateau and is skipped. Plateaus are only collected on nodes that can lie
+ * on a route within `maxTime`.
+ *
+ * @param g The graph.
+ * @param source The node ID of the starting location.
+ * @param dest The node ID of the destination location.
+ * @param maxTime The longest driving time of interest.
+ * @param count The maximum number of candidates, longest plateaus first.
+ * @return The candidates; the checkpoint is the first node of the plateau.
+ *
+ * @note Time Complexity: O(E + V + D + c log c), where D is the largest distance and c the number of plateaus.
+ */
+std::vector<AlternativeCandidate> plateauAlternatives(const Graph& g, int source, int dest, int maxTime, int count);
+
+/**
+ * @brief Picks the best alternative to a shortest route with the penalty and/or plateau method.
+ *
+ * Candidates must be loopless, at most 25% slower than the main route, share at most 80% of
+ * its time with it, and be locally optimal: the stretch of a quarter of the main route's time
+ * on each side of every checkpoint must be a shortest path. For a plateau candidate this is
+ * exact (only windows that cross the whole plateau can be suboptimal); for a penalty candidate
+ * it is checked around the start, middle and end of each detour, and candidates with more than
+ * two detours are dropped. Each test is one search bounded by the window's time, and tests run
+ * only until the best candidate that passes is found. The winner is the candidate with the
+ * smallest time plus shared time, so a slightly slower but really different route is preferred.
+ *
+ * @param g The graph.
+ * @param source The node ID of the starting location.
+ * @param dest The node ID of the destination location.
+ * @param mainPath The shortest route.
+ * @param strategy `Penalty`, `Plateau` or `Combined`.
+ * @return The alternative, or an empty vector if no candidate passes the filters.
+ *
+ * @note Time Complexity: O(E + V + D) times a constant number of searches (4 penalty rounds, 2 trees, and local tests on the best candidates until one passes, at most 6 per candidate).
+ */
+std::vector<int> filteredAlternativeRoute(const Graph& g, int source, int dest, const std::vector<int>& mainPath,
+    AlternativeStrategy strategy);
+
+#endif
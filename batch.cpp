@@ -1,64 +1,93 @@
 #include "batch.h"
 #include "parser.h"
 #include "route.h"
+#include "querycontext.h"
+#include "threadpool.h"
+#include "jsonl.h"
+#include "matrix.h"
+#include "kshortest.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <map>
+#include <tuple>
 
 using namespace std;
 
-// Variáveis globais que vêm do main
-
 /**
- * @brief Processes a batch file containing various routing operations.
- *
- * Reads a batch file and performs operations such as finding the best route, an alternative route, restricted routes, and eco-friendly routes.
- * The results are written to an output file.
+ * @brief Reads the next request of a batch file.
  *
- * @param g The graph representing the locations and edges.
- * @param inputPath The path to the input batch file.
- * @param outputPath The path to the output file where results will be written.
+ * @param request Receives the request (all keys not present in the record keep their defaults).
+ * @return False when the input has no more records.
  *
- * @note Time Complexity: O(n * m), where n is the number of locations and m is the number of operations in the batch file.
+ * @note Time Complexity: O(k), where k is the length of the record.
  */
-extern vector<Location> locations;
-extern vector<Edge> edges;
+bool BatchReader::next(BatchRequest& request) {
+    request = BatchRequest();
+    bool seen = false;   // o registo já tem pelo menos uma linha
+    string line;
 
-void processBatchFile(Graph& g, const string& inputPath, const string& outputPath) {
-    // Abrir ficheiros de input e output
-    ifstream input(inputPath);
-    ofstream output(outputPath);
-    if (!input.is_open() || !output.is_open()) {
-        cerr << "Erro ao abrir ficheiros." << endl;
-        return;
-    }
+    while (true) {
+        if (hasPending) {
+            line = std::move(pending);
+            hasPending = false;
+        } else if (!getline(input, line)) {
+            break;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
 
-    // Variáveis de controlo de dados lidos do input
-    string line;
-    string mode;
-    int sourceId = -1, destId = -1, includeNodeId = -1, maxWalkTime = -1;
-    set<int> avoidNodeIds;
-    set<pair<int, int>> avoidSegmentIds;
-
-    // Leitura do ficheiro linha a linha
-    while (getline(input, line)) {
-        if (line.find("Mode:") == 0)
-            mode = line.substr(5);  // Modo de operação (driving, restricted, walking)
+        // Separadores de registos: linha vazia ou "---"
+        if (line.empty() || line == "---") {
+            if (seen) return true;
+            continue;
+        }
+
+        if (line.find("Mode:") == 0) {
+            if (!request.mode.empty()) {
+                // Novo "Mode:" abre o registo seguinte
+                pending = line;
+                hasPending = true;
+                return true;
+            }
+            request.mode = line.substr(5);  // Modo de operação (driving, restricted, walking)
+        }
+        else if (line.find("Engine:") == 0) {
+            // Algoritmo usado nos modos driving e driving-restricted
+            if (!parseEngine(line.substr(7), request.engine))
+                cerr << "Motor desconhecido, a usar dijkstra: " << line.substr(7) << endl;
+        }
+        else if (line.find("Alternative:") == 0) {
+            // Estratégia da rota alternativa do modo driving
+            if (!parseAlternativeStrategy(line.substr(12), request.alternative))
+                cerr << "Estratégia alternativa desconhecida, a usar disjoint: " << line.substr(12) << endl;
+        }
         else if (line.find("Source:") == 0)
-            sourceId = stoi(line.substr(7)); // ID origem
+            request.sourceId = stoi(line.substr(7)); // ID origem
         else if (line.find("Destination:") == 0)
-            destId = stoi(line.substr(12)); // ID destino
+            request.destId = stoi(line.substr(12)); // ID destino
         else if (line.find("IncludeNode:") == 0 && line.size() > 12)
-            includeNodeId = stoi(line.substr(12)); // Nó obrigatório
+            request.includeNodeId = stoi(line.substr(12)); // Nó obrigatório
         else if (line.find("MaxWalkTime:") == 0 && line.size() > 12)
-            maxWalkTime = stoi(line.substr(12)); // Tempo máximo a pé
+            request.maxWalkTime = stoi(line.substr(12)); // Tempo máximo a pé
+        else if (line.find("K:") == 0 && line.size() > 2)
+            request.k = stoi(line.substr(2)); // Número de rotas do modo driving-k-shortest
+        else if (line.find("Metric:") == 0)
+            request.metric = cleanCode(line.substr(7)); // Tempo da matriz (driving ou walking)
+        else if (line.find("Sources:") == 0)
+            request.sources = line.substr(8); // Linhas da matriz
+        else if (line.find("Targets:") == 0)
+            request.targets = line.substr(8); // Colunas da matriz
+        else if (line.find("MatrixFile:") == 0)
+            request.matrixFile = cleanCode(line.substr(11)); // Ficheiro da matriz
+        else if (line.find("Format:") == 0)
+            request.matrixFormat = cleanCode(line.substr(7)); // csv ou binary
         else if (line.find("AvoidNodes:") == 0 && line.size() > 11) {
             // Leitura de nós a evitar
             stringstream ss(line.substr(11));
             string id;
             while (getline(ss, id, ',')) {
-                if (!id.empty()) avoidNodeIds.insert(stoi(id));
+                if (!id.empty()) request.avoidNodeIds.insert(stoi(id));
             }
         } else if (line.find("AvoidSegments:") == 0 && line.size() > 14) {
             // Leitura de segmentos a evitar (pares de IDs no formato (id1,id2))
@@ -73,123 +102,428 @@ void processBatchFile(Graph& g, const string& inputPath, const string& outputPat
                     string id1Str, id2Str;
                     if (getline(pairStream, id1Str, ',') && getline(pairStream, id2Str)) {
                         int id1 = stoi(id1Str), id2 = stoi(id2Str);
-                        avoidSegmentIds.insert({id1, id2});
-                        avoidSegmentIds.insert({id2, id1}); // guardar também inverso
+                        request.avoidSegmentIds.insert({id1, id2});
+                        request.avoidSegmentIds.insert({id2, id1}); // guardar também inverso
                     }
                 }
             }
         }
+        seen = true;
     }
+    return seen;
+}
 
-    // Converte os IDs para códigos
-    string sourceCode = getCodeById(locations, sourceId);
-    string destCode = getCodeById(locations, destId);
-    string includeCode = (includeNodeId != -1) ? getCodeById(locations, includeNodeId) : "";
+/**
+ * @struct ResolvedRequest
+ * @brief A batch request with its location IDs converted to node IDs.
+ */
+struct ResolvedRequest {
+    int source;
+    int dest;
+    int include;                         // -1 se não houver nó obrigatório
+    set<int> avoidNodes;
+    set<pair<int, int>> avoidSegments;
+};
 
-    // Converte IDs de nós a evitar para códigos
-    set<string> avoidCodes;
-    for (int id : avoidNodeIds)
-        avoidCodes.insert(getCodeById(locations, id));
+/**
+ * @brief Converts the location IDs of a request to node IDs.
+ *
+ * @note Time Complexity: O(a log a), where a is the size of the avoid lists.
+ */
+static ResolvedRequest resolveRequest(const SymbolTable& symbols, const BatchRequest& request) {
+    ResolvedRequest r;
 
-    // Converte segmentos proibidos para códigos
-    set<pair<string, string>> avoidSegmentCodes;
-    for (const auto& [id1, id2] : avoidSegmentIds) {
-        avoidSegmentCodes.insert({getCodeById(locations, id1), getCodeById(locations, id2)});
-    }
+    // Converte os IDs dos locais para nós do grafo (tabela de símbolos, O(1))
+    r.source = symbols.fromLocationId(request.sourceId);
+    r.dest = symbols.fromLocationId(request.destId);
+    r.include = (request.includeNodeId != -1) ? symbols.fromLocationId(request.includeNodeId) : -1;
 
-    // Escreve os dados base no output
-    output << "Source:" << sourceId << "\nDestination:" << destId << "\n";
+    // Converte IDs de nós a evitar
+    for (int id : request.avoidNodeIds)
+        r.avoidNodes.insert(symbols.fromLocationId(id));
 
-    //  Funcionalidade 1 e 2: Melhor rota e rota alternativa
-    if (mode == "driving") {
-        auto path = dijkstraShortestPath(g, sourceCode, destCode);
-        auto alt = findAlternativeRoute(g, sourceCode, destCode, path);
-        int t1 = calculateDrivingTime(g, path);
-        int t2 = calculateDrivingTime(g, alt);
+    // Converte segmentos proibidos
+    for (const auto& [id1, id2] : request.avoidSegmentIds) {
+        r.avoidSegments.insert({symbols.fromLocationId(id1), symbols.fromLocationId(id2)});
+    }
+    return r;
+}
 
-        // Melhor rota
-        output << "BestDrivingRoute:";
-        if (path.empty()) output << "none\n";
-        else {
-            for (size_t i = 0; i < path.size(); ++i) {
-                output << getIdByCode(locations, path[i]);
-                if (i < path.size() - 1) output << ",";
-            }
-            output << "(" << t1 << ")\n";
+/**
+ * @brief Converts a list of locations of a matrix request to node IDs.
+ *
+ * @param symbols The symbol table.
+ * @param spec "all", "parking" or a comma-separated list of location IDs (unknown IDs are skipped).
+ * @return The node IDs, in the order given (node order for "all" and "parking").
+ *
+ * @note Time Complexity: O(V) for "all" and "parking", O(k) for a list of k IDs.
+ */
+static vector<int> resolveNodeList(const SymbolTable& symbols, const string& spec) {
+    vector<int> nodes;
+    string key = cleanCode(spec);
+    if (key == "all" || key == "parking") {
+        for (int v = 0; v < symbols.size(); ++v) {
+            if (key == "all" || symbols.hasParking(v)) nodes.push_back(v);
         }
+        return nodes;
+    }
 
-        // Alternativa
-        output << "AlternativeDrivingRoute:";
-        if (alt.empty()) output << "none\n";
-        else {
-            for (size_t i = 0; i < alt.size(); ++i) {
-                output << getIdByCode(locations, alt[i]);
-                if (i < alt.size() - 1) output << ",";
-            }
-            output << "(" << t2 << ")\n";
+    stringstream ss(key);
+    string id;
+    while (getline(ss, id, ',')) {
+        if (id.empty()) continue;
+        int node = symbols.fromLocationId(stoi(id));
+        if (node == -1) cerr << "Local desconhecido na matriz: " << id << endl;
+        else nodes.push_back(node);
+    }
+    return nodes;
+}
+
+/**
+ * @brief Computes the travel-time matrix of a `matrix` request and writes it to its file, if it has one.
+ *
+ * @param net The network representing the locations and edges.
+ * @param request The request.
+ * @param pool The pool that runs the searches, or null.
+ * @return The result with the matrix (left empty once written to a file).
+ *
+ * @note Time Complexity: that of `travelTimeMatrix`, plus O(S * T) to write it.
+ */
+static BatchResult solveMatrix(const Network& net, const BatchRequest& request, WorkStealingPool* pool) {
+    const SymbolTable& symbols = net.graph.symbols();
+    BatchResult result;
+    result.matrixSources = resolveNodeList(symbols, request.sources);
+    result.matrixTargets = resolveNodeList(symbols, request.targets);
+
+    TravelMode mode = request.metric == "walking" ? TravelMode::Walking : TravelMode::Driving;
+    result.matrix = travelTimeMatrix(net, result.matrixSources, result.matrixTargets, mode, pool);
+
+    if (!request.matrixFile.empty()) {
+        bool binary = request.matrixFormat == "binary";
+        ResultWriter file(request.matrixFile, binary);
+        if (!file.good()) {
+            result.message = "Could not write " + request.matrixFile + ".";
+            return result;
         }
+        if (binary) writeMatrixBinary(symbols, result.matrixSources, result.matrixTargets, result.matrix, file);
+        else writeMatrixCsv(symbols, result.matrixSources, result.matrixTargets, result.matrix, file);
+        result.matrix.clear();   // já está no ficheiro
+    }
+    return result;
+}
+
+/**
+ * @brief Computes the routes of a resolved request.
+ *
+ * @param net The network representing the locations and edges.
+ * @param request The request.
+ * @param r The request's node IDs.
+ * @param firstLeg If not null, the already computed driving route from the source to the include
+ *                 node (or to the destination when there is none), so it is not searched again.
+ * @param pool The pool that runs the searches of the `matrix` and `driving-k-shortest` modes, or null.
+ * @return The routes, as node IDs.
+ *
+ * @note Time Complexity: that of the searches the mode needs.
+ */
+static BatchResult solveResolved(const Network& net, const BatchRequest& request, const ResolvedRequest& r,
+                                 const vector<int>* firstLeg, WorkStealingPool* pool = nullptr) {
+    const Graph& g = net.graph;
+    const string& mode = request.mode;
+    Engine engine = request.engine;
+    BatchResult result;
+
+    //  Funcionalidade 1 e 2: Melhor rota e rota alternativa
+    if (mode == "driving") {
+        result.route = firstLeg ? *firstLeg : drivingRoute(net, engine, r.source, r.dest, {}, {});
+        result.alternative = findAlternativeRoute(g, r.source, r.dest, result.route, request.alternative);
 
     //  Rota com restrições
     } else if (mode == "driving-restricted") {
-        vector<string> path;
-        if (!includeCode.empty()) {
+        if (r.include != -1) {
             // Se houver nó obrigatório, divide o percurso em duas partes
-            auto p1 = dijkstraRestricted(g, sourceCode, includeCode, avoidCodes, avoidSegmentCodes);
-            auto p2 = dijkstraRestricted(g, includeCode, destCode, avoidCodes, avoidSegmentCodes);
+            auto p1 = firstLeg ? *firstLeg : drivingRoute(net, engine, r.source, r.include, r.avoidNodes, r.avoidSegments);
+            auto p2 = drivingRoute(net, engine, r.include, r.dest, r.avoidNodes, r.avoidSegments);
             if (!p1.empty() && !p2.empty()) {
                 p1.pop_back(); // evita duplicação
-                path = p1;
-                path.insert(path.end(), p2.begin(), p2.end());
+                result.route = p1;
+                result.route.insert(result.route.end(), p2.begin(), p2.end());
             }
         } else {
             // Caso contrário faz o caminho direto com restrições
-            path = dijkstraRestricted(g, sourceCode, destCode, avoidCodes, avoidSegmentCodes);
-        }
-
-        // Escreve resultado
-        output << "RestrictedDrivingRoute:";
-        if (path.empty()) output << "none\n";
-        else {
-            for (size_t i = 0; i < path.size(); ++i) {
-                output << getIdByCode(locations, path[i]);
-                if (i < path.size() - 1) output << ",";
-            }
-            output << "(" << calculateDrivingTime(g, path) << ")\n";
+            result.route = firstLeg ? *firstLeg : drivingRoute(net, engine, r.source, r.dest, r.avoidNodes, r.avoidSegments);
         }
 
     //  Eco-route
     } else if (mode == "driving-walking") {
-        string message;
-
         // tenta encontrar melhor parque com base em critérios
-        auto [drivePath, parking, walkPath] = findEcoRoute(g, sourceCode, destCode, maxWalkTime, avoidCodes, avoidSegmentCodes, message);
+        auto [drivePath, parking, walkPath] = findEcoRoute(g, r.source, r.dest, request.maxWalkTime, r.avoidNodes, r.avoidSegments, result.message);
+        if (!drivePath.empty() && !walkPath.empty()) {
+            result.route = std::move(drivePath);
+            result.parking = parking;
+            result.walk = std::move(walkPath);
+        }
+
+    //  K rotas mais rápidas
+    } else if (mode == "driving-k-shortest") {
+        result.ranked = kShortestPaths(g, r.source, r.dest, request.k, r.avoidNodes, r.avoidSegments, pool);
+
+    //  Matriz de tempos
+    } else if (mode == "matrix") {
+        result = solveMatrix(net, request, pool);
+    }
+    return result;
+}
+
+/**
+ * @brief Computes the routes a batch request asks for.
+ *
+ * @param net The network representing the locations and edges.
+ * @param request The request, with location IDs as written in the batch file.
+ * @return The routes, as node IDs.
+ *
+ * @note Time Complexity: that of the searches the mode needs.
+ */
+BatchResult solveBatchRequest(const Network& net, const BatchRequest& request) {
+    ResolvedRequest r = resolveRequest(net.graph.symbols(), request);
+    return solveResolved(net, request, r, nullptr);
+}
+
+/**
+ * @brief Returns whether the first driving leg of a request can be read from a shared Dijkstra tree.
+ *
+ * Only `driving` and `driving-restricted` requests on the Dijkstra engine qualify: the tree is
+ * the same full search `dijkstraRestricted` runs, so the answer is exactly the one the request
+ * would get on its own.
+ */
+static bool sharesSourceTree(const BatchRequest& request) {
+    return request.engine == Engine::Dijkstra && (request.mode == "driving" || request.mode == "driving-restricted");
+}
+
+/**
+ * @brief Answers a group of requests with the same source and restrictions from one search tree.
+ *
+ * The first legs of every member are read from the tree before any other search runs (the
+ * remaining work of each member reuses the same per-thread context).
+ *
+ * @note Time Complexity: O(E + V + D) for the tree, plus the per-request work that is not shared.
+ */
+static void solveSourceGroup(const Network& net, const vector<BatchRequest>& requests,
+                             const vector<size_t>& members, vector<BatchResult>& results) {
+    const Graph& g = net.graph;
+    const BatchRequest& first = requests[members[0]];
+    ResolvedRequest common = resolveRequest(g.symbols(), first);
+    if (first.mode == "driving") {
+        common.avoidNodes.clear();      // o modo driving ignora as restrições
+        common.avoidSegments.clear();
+    }
+
+    // Uma única árvore de caminhos mais curtos para todo o grupo
+    QueryContext& tree = threadQueryContext();
+    oneToMany(g, tree, common.source, TravelMode::Driving, common.avoidNodes, common.avoidSegments);
+
+    vector<ResolvedRequest> resolved;
+    vector<vector<int>> legs;
+    for (size_t i : members) {
+        resolved.push_back(resolveRequest(g.symbols(), requests[i]));
+        const ResolvedRequest& r = resolved.back();
+        int target = (requests[i].mode == "driving-restricted" && r.include != -1) ? r.include : r.dest;
+        legs.push_back((common.source < 0 || target < 0) ? vector<int>() : tree.path(common.source, target));
+    }
+
+    for (size_t k = 0; k < members.size(); ++k)
+        results[members[k]] = solveResolved(net, requests[members[k]], resolved[k], &legs[k]);
+}
+
+/**
+ * @brief Computes the results of a list of batch requests in parallel.
+ *
+ * @param net The network representing the locations and edges.
+ * @param pool The pool that runs the searches.
+ * @param requests The requests (only the first `count` are used).
+ * @param count The number of requests.
+ * @param results Receives the result of request i at position i (resized if needed).
+ *
+ * @note Time Complexity: O(r * q / t), with one search tree per group of requests that share a source and restrictions.
+ */
+void solveBatch(const Network& net, WorkStealingPool& pool, const vector<BatchRequest>& requests, size_t count,
+                vector<BatchResult>& results) {
+    if (results.size() < count) results.resize(count);
+
+    // Agrupa por (origem, nós a evitar, segmentos a evitar); as restrições não contam no modo driving
+    map<tuple<int, set<int>, set<pair<int, int>>>, vector<size_t>> groups;
+    vector<vector<size_t>> units;   // unidades de trabalho: um grupo ou um pedido isolado
+    for (size_t i = 0; i < count; ++i) {
+        const BatchRequest& request = requests[i];
+        if (request.mode == "matrix" || request.mode == "driving-k-shortest") {
+            // Paralelos por dentro: correm já, nesta thread, com o pool todo
+            results[i] = solveResolved(net, request, resolveRequest(net.graph.symbols(), request), nullptr, &pool);
+            continue;
+        }
+        if (!sharesSourceTree(request)) {
+            units.push_back({i});
+            continue;
+        }
+        bool unrestricted = request.mode == "driving";
+        groups[make_tuple(request.sourceId,
+                          unrestricted ? set<int>() : request.avoidNodeIds,
+                          unrestricted ? set<pair<int, int>>() : request.avoidSegmentIds)].push_back(i);
+    }
+    for (auto& [key, members] : groups)
+        units.push_back(std::move(members));
+
+    size_t grain = max<size_t>(1, units.size() / (pool.size() * 8));
+    parallelFor(pool, units.size(), grain, [&](size_t begin, size_t end) {
+        for (size_t u = begin; u < end; ++u) {
+            const vector<size_t>& members = units[u];
+            if (members.size() == 1) results[members[0]] = solveBatchRequest(net, requests[members[0]]);
+            else solveSourceGroup(net, requests, members, results);
+        }
+    });
+}
+
+/**
+ * @brief Writes a route as comma-separated location IDs followed by its time, or "none".
+ *
+ * @note Time Complexity: O(n), where n is the number of nodes in the path.
+ */
+static void writeRoute(const SymbolTable& symbols, const vector<int>& path, int time, ResultWriter& output) {
+    if (path.empty()) {
+        output << "none\n";
+        return;
+    }
+    for (size_t i = 0; i < path.size(); ++i) {
+        output << symbols.locationId(path[i]);
+        if (i < path.size() - 1) output << ",";
+    }
+    output << "(" << time << ")\n";
+}
+
+/**
+ * @brief Writes the output block of a batch request in the text format.
+ *
+ * @param g The graph the routes belong to.
+ * @param request The request.
+ * @param result The routes computed for it.
+ * @param output The writer that receives the block.
+ *
+ * @note Time Complexity: O(p), where p is the total length of the routes.
+ */
+void writeBatchResult(const Graph& g, const BatchRequest& request, const BatchResult& result, ResultWriter& output) {
+    const SymbolTable& symbols = g.symbols();
+    const string& mode = request.mode;
+
+    //  Matriz: linhas, colunas e tempos em CSV (ou o ficheiro onde foi escrita)
+    if (mode == "matrix") {
+        output << "Matrix:" << request.metric << "\n";
+        output << "Size:" << result.matrixSources.size() << "x" << result.matrixTargets.size() << "\n";
+        if (!result.message.empty()) output << "Message:" << result.message << "\n";
+        else if (!request.matrixFile.empty()) output << "MatrixFile:" << request.matrixFile << "\n";
+        else writeMatrixCsv(symbols, result.matrixSources, result.matrixTargets, result.matrix, output);
+        return;
+    }
+
+    // Escreve os dados base no output
+    output << "Source:" << request.sourceId << "\nDestination:" << request.destId << "\n";
+
+    if (mode == "driving") {
+        output << "BestDrivingRoute:";
+        writeRoute(symbols, result.route, calculateDrivingTime(g, result.route), output);
+        output << "AlternativeDrivingRoute:";
+        writeRoute(symbols, result.alternative, calculateDrivingTime(g, result.alternative), output);
+
+    } else if (mode == "driving-restricted") {
+        output << "RestrictedDrivingRoute:";
+        writeRoute(symbols, result.route, calculateDrivingTime(g, result.route), output);
 
+    } else if (mode == "driving-walking") {
         // se falhar
-        if (drivePath.empty() || walkPath.empty()) {
+        if (result.parking == -1) {
             output << "DrivingRoute:none\nParkingNode:none\nWalkingRoute:none\nTotalTime:\n";
-            output << "Message:" << message << "\n";
+            output << "Message:" << result.message << "\n";
         } else {
             // caso nao falhe
-            int driveTime = calculateDrivingTime(g, drivePath);
-            int walkTime = calculateWalkingTime(g, walkPath);
+            int driveTime = calculateDrivingTime(g, result.route);
+            int walkTime = calculateWalkingTime(g, result.walk);
 
             output << "DrivingRoute:";
-            for (size_t i = 0; i < drivePath.size(); ++i) {
-                output << getIdByCode(locations, drivePath[i]);
-                if (i < drivePath.size() - 1) output << ",";
-            }
-            output << "(" << driveTime << ")\n";
+            writeRoute(symbols, result.route, driveTime, output);
+            output << "ParkingNode:" << symbols.locationId(result.parking) << "\n";
+            output << "WalkingRoute:";
+            writeRoute(symbols, result.walk, walkTime, output);
+            output << "TotalTime:" << (driveTime + walkTime) << "\n";
+        }
 
-            output << "ParkingNode:" << getIdByCode(locations, parking) << "\n";
+    } else if (mode == "driving-k-shortest") {
+        output << "RankedDrivingRoutes:" << result.ranked.size() << "\n";
+        for (size_t i = 0; i < result.ranked.size(); ++i) {
+            output << "Route" << (i + 1) << ":";
+            writeRoute(symbols, result.ranked[i].path, result.ranked[i].time, output);
+        }
+    }
+}
 
-            output << "WalkingRoute:";
-            for (size_t i = 0; i < walkPath.size(); ++i) {
-                output << getIdByCode(locations, walkPath[i]);
-                if (i < walkPath.size() - 1) output << ",";
-            }
-            output << "(" << walkTime << ")\n";
+/**
+ * @brief Answers one batch request and writes its output block.
+ *
+ * @param net The network representing the locations and edges.
+ * @param request The request, with location IDs as written in the batch file.
+ * @param output The writer that receives the block.
+ *
+ * @note Time Complexity: that of the searches the mode needs.
+ */
+void answerBatchRequest(const Network& net, const BatchRequest& request, ResultWriter& output) {
+    writeBatchResult(net.graph, request, solveBatchRequest(net, request), output);
+}
 
-            output << "TotalTime:" << (driveTime + walkTime) << "\n";
+/**
+ * @brief Processes a batch file containing various routing operations.
+ *
+ * @param net The network representing the locations and edges.
+ * @param inputPath The path to the input batch file.
+ * @param outputPath The path to the output file where results will be written.
+ * @param threads The number of worker threads; 0 uses one per hardware thread.
+ *
+ * @note Time Complexity: O(r * q / t), where r is the number of requests, q the cost of one request and t the number of threads.
+ */
+void processBatchFile(const Network& net, const string& inputPath, const string& outputPath, int threads) {
+    const size_t chunkSize = 4096;   // pedidos lidos de cada vez (limita a memória usada)
+
+    // Um pedido JSON por linha
+    const string jsonl = ".jsonl";
+    if (inputPath.size() >= jsonl.size() && inputPath.compare(inputPath.size() - jsonl.size(), jsonl.size(), jsonl) == 0) {
+        processJsonlFile(net, inputPath, outputPath, threads);
+        return;
+    }
+
+    // Abrir ficheiros de input e output
+    ifstream input(inputPath);
+    ResultWriter output(outputPath);
+    if (!input.is_open() || !output.good()) {
+        cerr << "Erro ao abrir ficheiros." << endl;
+        return;
+    }
+
+    WorkStealingPool pool(threads);
+    BatchReader reader(input);
+    vector<BatchRequest> requests(chunkSize);
+    vector<BatchResult> results(chunkSize);
+    bool first = true;
+
+    while (true) {
+        // Lê um bloco de registos
+        size_t count = 0;
+        while (count < chunkSize && reader.next(requests[count])) count++;
+        if (count == 0) break;
+
+        // Responde em paralelo (agrupados por origem); cada resultado fica na posição do seu pedido
+        solveBatch(net, pool, requests, count, results);
+
+        // Escreve pela ordem do ficheiro de entrada
+        for (size_t i = 0; i < count; ++i) {
+            if (!first) output << "\n";   // linha vazia entre blocos
+            first = false;
+            writeBatchResult(net.graph, requests[i], results[i], output);
         }
+        if (count < chunkSize) break;
     }
 }
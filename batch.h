@@ -2,20 +2,176 @@
 #define BATCH_HPP
 
 #include <string>
-#include "graph.h"
+#include <set>
+#include <utility>
+#include <vector>
+#include <istream>
+#include "writer.h"
+#include "network.h"
+#include "engine.h"
+#include "kshortest.h"
+#include "route.h"
+
+class WorkStealingPool;
+
+/**
+ * @struct BatchRequest
+ * @brief One routing request of a batch file, with the location IDs as written in the file.
+ */
+struct BatchRequest {
+    std::string mode;                                 // driving, driving-restricted, driving-walking, driving-k-shortest ou matrix
+    Engine engine = Engine::Dijkstra;
+    AlternativeStrategy alternative = AlternativeStrategy::Disjoint;   // rota alternativa do modo driving
+    int sourceId = -1;
+    int destId = -1;
+    int includeNodeId = -1;                           // -1 se não houver nó obrigatório
+    int maxWalkTime = -1;
+    std::set<int> avoidNodeIds;
+    std::set<std::pair<int, int>> avoidSegmentIds;    // guardados nos dois sentidos
+    std::string id;                                   // "id" de um pedido JSONL (texto JSON original), ecoado na resposta
+    int k = 3;                                        // modo driving-k-shortest: número máximo de rotas
+
+    // Modo matrix
+    std::string metric = "driving";                   // driving ou walking
+    std::string sources;                              // "all", "parking" ou lista de IDs separados por vírgulas
+    std::string targets;
+    std::string matrixFile;                           // vazio: a matriz vai no bloco de output
+    std::string matrixFormat = "csv";                 // csv ou binary (só com matrixFile)
+};
+
+/**
+ * @struct BatchResult
+ * @brief The routes computed for one batch request, as node IDs (empty when there is none).
+ */
+struct BatchResult {
+    std::vector<int> route;         // driving: melhor rota; driving-restricted: rota; driving-walking: parte de carro
+    std::vector<int> alternative;   // só no modo driving
+    int parking = -1;               // só no modo driving-walking (-1 se não houver rota)
+    std::vector<int> walk;          // só no modo driving-walking
+    std::string message;            // mensagem do modo driving-walking (ou erro do modo matrix)
+    std::vector<int> matrixSources; // modo matrix: linhas, colunas e tempos (INT_MAX se inalcançável)
+    std::vector<int> matrixTargets;
+    std::vector<int> matrix;
+    std::vector<RankedRoute> ranked; // modo driving-k-shortest, da mais rápida para a mais lenta
+};
+
+/**
+ * @class BatchReader
+ * @brief Reads the requests of a batch file one at a time.
+ *
+ * A file holds one or more records of `Key:value` lines.
+ * The `driving` mode takes an optional `Alternative:` line (`disjoint`, `penalty`, `plateau`
+ * or `combined`, see `findAlternativeRoute`).
+ * The `driving-k-shortest` mode takes `K:` (the number of routes, 3 by default) and the avoid lists.
+ * The `matrix` mode takes `Metric:` (driving or walking), `Sources:` and `Targets:` (`all`,
+ * `parking` or a list of location IDs) and optionally `MatrixFile:` and `Format:` (csv or binary). A record ends at an empty line, at a
+ * `---` line, or where a new `Mode:` line starts the next record, so a classic single-request
+ * Input.txt is a file with one record. Keys do not carry over between records.
+ */
+class BatchReader {
+private:
+    std::istream& input;
+    std::string pending;        // linha "Mode:" já lida que abre o registo seguinte
+    bool hasPending = false;
+
+public:
+    explicit BatchReader(std::istream& input) : input(input) {}
+
+    /**
+     * @brief Reads the next request.
+     *
+     * @param request Receives the request.
+     * @return False when the input has no more records.
+     *
+     * @note Time Complexity: O(k), where k is the length of the record.
+     */
+    bool next(BatchRequest& request);
+};
+
+/**
+ * @brief Computes the routes a batch request asks for.
+ *
+ * The `driving` mode computes the best and the alternative route (with the request's
+ * `Alternative` strategy), `driving-restricted` the
+ * restricted route (through `IncludeNode` if given), `driving-walking` the eco route,
+ * `driving-k-shortest` the K fastest loopless routes that respect the avoid lists (see
+ * `kShortestPaths`; always on Dijkstra) and `matrix` the travel times between every source and target (see `travelTimeMatrix`), written to
+ * `MatrixFile` if one is given. The request's engine selects the algorithm of the `driving` and `driving-restricted` modes.
+ *
+ * @param net The network in which to find the routes.
+ * @param request The request.
+ * @return The routes; an unknown mode gives an empty result.
+ *
+ * @note Time Complexity: that of the searches the mode needs.
+ */
+BatchResult solveBatchRequest(const Network& net, const BatchRequest& request);
+
+/**
+ * @brief Computes the results of a list of batch requests in parallel.
+ *
+ * Requests are reordered into groups: `driving` and `driving-restricted` requests on the
+ * Dijkstra engine that share the source and the restrictions are answered from one full
+ * shortest-path tree (the same tree each of them would have searched alone), and every other
+ * request is a group of its own. Groups run in parallel on the pool (`matrix` and
+ * `driving-k-shortest` requests are parallel internally and run on their own); results are stored at the
+ * index of their request, so the caller can emit them in the original order.
+ *
+ * @param net The network in which to find the routes.
+ * @param pool The pool that runs the searches.
+ * @param requests The requests (only the first `count` are used).
+ * @param count The number of requests.
+ * @param results Receives the result of request i at position i (resized if needed).
+ *
+ * @note Time Complexity: O(r * q / t), with one search tree per group of requests that share a source and restrictions.
+ */
+void solveBatch(const Network& net, WorkStealingPool& pool, const std::vector<BatchRequest>& requests, size_t count,
+    std::vector<BatchResult>& results);
+
+/**
+ * @brief Writes the text output block of a batch request (Source, Destination and the routes with their times, or the matrix).
+ *
+ * The `driving-k-shortest` mode writes `RankedDrivingRoutes:n`, then `Route1:` to `Routen:`.
+ *
+ * @param g The graph the routes belong to.
+ * @param request The request.
+ * @param result The routes computed for it.
+ * @param output The writer that receives the block.
+ *
+ * @note Time Complexity: O(p), where p is the total length of the routes.
+ */
+void writeBatchResult(const Graph& g, const BatchRequest& request, const BatchResult& result, ResultWriter& output);
+
+/**
+ * @brief Answers one batch request and writes its output block.
+ *
+ * Equivalent to `writeBatchResult(net.graph, request, solveBatchRequest(net, request), output)`.
+ *
+ * @param net The network in which to find the routes.
+ * @param request The request.
+ * @param output The writer that receives the block.
+ *
+ * @note Time Complexity: that of the searches the mode needs.
+ */
+void answerBatchRequest(const Network& net, const BatchRequest& request, ResultWriter& output);
 
 /**
  * @brief Processes a batch file containing various routing operations.
  *
- * Reads a batch file and performs operations such as finding the best route, an alternative route, restricted routes, and eco-friendly routes.
- * The results are written to an output file.
+ * Reads a batch file and performs operations such as finding the best route, an alternative route, restricted routes, eco-friendly routes and the k fastest routes.
+ * The results are written to an output file. An optional `Engine:` line (`dijkstra`, `bidirectional`, `alt`, `ch` or `cch`) selects the
+ * shortest-path algorithm used by the `driving` and `driving-restricted` modes.
+ * Requests are streamed in chunks through the loaded network (see `BatchReader`) and answered
+ * in parallel on a work-stealing pool (see `solveBatch`); the network is only read, and every
+ * worker thread has its own search state. Output blocks are written in request order, separated by an empty line.
+ * An input path ending in `.jsonl` is processed as JSON Lines instead (see `processJsonlFile`).
  *
- * @param g The graph representing the locations and edges.
+ * @param net The network representing the locations and edges.
  * @param inputPath The path to the input batch file.
- * @param outputPath The path to the output file where results will be written.
+ * @param outputPath The path to the output file where results will be written ("-" writes to stdout).
+ * @param threads The number of worker threads; 0 uses one per hardware thread.
  *
- * @note Time Complexity: O(n * m), where n is the number of locations and m is the number of operations in the batch file.
+ * @note Time Complexity: O(r * q / t), where r is the number of requests, q the cost of one request and t the number of threads.
  */
-void processBatchFile(Graph& g, const std::string& inputPath, const std::string& outputPath);
+void processBatchFile(const Network& net, const std::string& inputPath, const std::string& outputPath, int threads = 0);
 
 #endif
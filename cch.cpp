@@ -0,0 +1,641 @@
+#include "cch.h"
+#include "querycontext.h"
+#include <algorithm>
+#include <climits>
+#include <queue>
+
+/**
+ * @brief Orders a set of nodes by nested dissection.
+ *
+ * Each connected part is split by a BFS level of a pseudo-peripheral node: the nodes before
+ * the median level and after it are ordered first (recursively), and the separating level
+ * gets the highest ranks of the part. Small parts are appended as they are.
+ *
+ * @param gv The graph.
+ * @param nodes The nodes to order.
+ * @param mark Scratch array; `mark[v] == tag` marks the nodes of the current part.
+ * @param level Scratch array with BFS levels.
+ * @param tag The next unused tag value (incremented as parts are created).
+ * @param order Receives the nodes, lowest rank first.
+ *
+ * @note Time Complexity: O((V + E) * log V) for balanced separators.
+ */
+static void dissect(GraphView gv, vector<int> nodes, vector<int>& mark, vector<int>& level, int& tag, vector<int>& order) {
+    const size_t leafSize = 16;
+    if (nodes.size() <= leafSize) {
+        order.insert(order.end(), nodes.begin(), nodes.end());
+        return;
+    }
+
+    int current = ++tag;
+    for (int v : nodes) mark[v] = current;
+
+    // BFS dentro da parte; devolve os nós visitados por ordem
+    auto bfs = [&](int start, vector<int>& visited) {
+        int seen = ++tag;
+        visited.clear();
+        visited.push_back(start);
+        level[start] = 0;
+        mark[start] = seen;
+        for (size_t i = 0; i < visited.size(); ++i) {
+            int u = visited[i];
+            for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+                int v = gv.target(e);
+                if (mark[v] != current) continue;
+                mark[v] = seen;
+                level[v] = level[u] + 1;
+                visited.push_back(v);
+            }
+        }
+        for (int v : visited) mark[v] = current;   // repõe a marca da parte
+    };
+
+    vector<int> visited;
+    bfs(nodes[0], visited);
+
+    if (visited.size() < nodes.size()) {
+        // Parte desconexa: ordena cada componente separadamente
+        vector<vector<int>> components;
+        int done = ++tag;
+        for (int v : nodes) {
+            if (mark[v] != current) continue;
+            bfs(v, visited);
+            for (int x : visited) mark[x] = done;
+            components.push_back(visited);
+        }
+        for (auto& comp : components)
+            dissect(gv, std::move(comp), mark, level, tag, order);
+        return;
+    }
+
+    // Nó pseudo-periférico: o último da BFS; nova BFS a partir dele
+    bfs(visited.back(), visited);
+
+    // Nível mediano como separador (nunca o nível 0, para que ambas as partes diminuam)
+    int split = max(1, level[visited[visited.size() / 2]]);
+
+    vector<int> before, after, separator;
+    for (int v : visited) {
+        if (level[v] < split) before.push_back(v);
+        else if (level[v] > split) after.push_back(v);
+        else separator.push_back(v);
+    }
+    dissect(gv, std::move(before), mark, level, tag, order);
+    dissect(gv, std::move(after), mark, level, tag, order);
+    order.insert(order.end(), separator.begin(), separator.end());
+}
+
+/**
+ * @brief Builds the metric-independent topology of a graph.
+ *
+ * Computes the nested-dissection order, then the chordal completion: eliminating the nodes in
+ * rank order, the upward neighbours of each node (minus the lowest one, its elimination tree
+ * parent) are added to the upward neighbours of that parent.
+ *
+ * @param g The graph.
+ *
+ * @note Time Complexity: O(V log V + E) for the ordering plus the size of the chordal completion.
+ */
+CchTopology::CchTopology(const Graph& g) {
+    GraphView gv = g.view();
+    int n = gv.nodeCount();
+    vector<int> rankArray, byRankArray, etreeParentArray, upOffsetsArray, upTargetsArray;
+    vector<int> downOffsetsArray, downSourcesArray, downArcsArray;
+
+    vector<int> all(n), mark(n, 0), level(n, 0);
+    for (int v = 0; v < n; ++v) all[v] = v;
+    int tag = 0;
+    dissect(gv, std::move(all), mark, level, tag, byRankArray);
+
+    rankArray.assign(n, 0);
+    for (int i = 0; i < n; ++i) rankArray[byRankArray[i]] = i;
+
+    // Vizinhos ascendentes de cada nó (todos os segmentos, conduzíveis ou não)
+    vector<vector<int>> up(n);
+    for (int u = 0; u < n; ++u) {
+        for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+            int v = gv.target(e);
+            if (rankArray[u] < rankArray[v]) up[u].push_back(v);
+        }
+    }
+
+    // Eliminação pela ordem: completa os vizinhos ascendentes num clique
+    auto byNodeRank = [&](int a, int b) { return rankArray[a] < rankArray[b]; };
+    etreeParentArray.assign(n, -1);
+    for (int i = 0; i < n; ++i) {
+        int v = byRankArray[i];
+        auto& nb = up[v];
+        sort(nb.begin(), nb.end(), byNodeRank);
+        nb.erase(unique(nb.begin(), nb.end()), nb.end());
+        if (nb.empty()) continue;
+
+        int p = nb[0];
+        etreeParentArray[v] = p;
+        up[p].insert(up[p].end(), nb.begin() + 1, nb.end());
+    }
+
+    // Arcos ascendentes em CSR
+    upOffsetsArray.assign(n + 1, 0);
+    for (int v = 0; v < n; ++v)
+        upOffsetsArray[v + 1] = upOffsetsArray[v] + (int)up[v].size();
+    upTargetsArray.reserve(upOffsetsArray[n]);
+    for (int v = 0; v < n; ++v)
+        upTargetsArray.insert(upTargetsArray.end(), up[v].begin(), up[v].end());
+
+    // Arcos descendentes (índice inverso), usados para desdobrar atalhos
+    downOffsetsArray.assign(n + 1, 0);
+    for (int a = 0; a < (int)upTargetsArray.size(); ++a)
+        downOffsetsArray[upTargetsArray[a] + 1]++;
+    for (int v = 0; v < n; ++v)
+        downOffsetsArray[v + 1] += downOffsetsArray[v];
+    downSourcesArray.resize(upTargetsArray.size());
+    downArcsArray.resize(upTargetsArray.size());
+    vector<int> cursor(downOffsetsArray.begin(), downOffsetsArray.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        for (int a = upOffsetsArray[v]; a < upOffsetsArray[v + 1]; ++a) {
+            int slot = cursor[upTargetsArray[a]]++;
+            downSourcesArray[slot] = v;
+            downArcsArray[slot] = a;
+        }
+    }
+
+    rank = std::move(rankArray);
+    byRank = std::move(byRankArray);
+    etreeParent = std::move(etreeParentArray);
+    upOffsets = std::move(upOffsetsArray);
+    upTargets = std::move(upTargetsArray);
+    downOffsets = std::move(downOffsetsArray);
+    downSources = std::move(downSourcesArray);
+    downArcs = std::move(downArcsArray);
+
+    // Correspondência arco do grafo -> arco da hierarquia
+    vector<int> inputArcArray(gv.edgeCount(), -1);
+    for (int u = 0; u < n; ++u) {
+        for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+            if (gv.target(e) != u) inputArcArray[e] = findArc(u, gv.target(e));
+        }
+    }
+    inputArc = std::move(inputArcArray);
+}
+
+/**
+ * @brief Finds the hierarchy arc between two nodes, in either order.
+ *
+ * @param a One end of the arc.
+ * @param b The other end of the arc.
+ * @return The arc ID, or -1 if the nodes are not adjacent in the hierarchy.
+ *
+ * @note Time Complexity: O(log d), where d is the upward degree of the lower-ranked node.
+ */
+int CchTopology::findArc(int a, int b) const {
+    if (rank[a] > rank[b]) swap(a, b);
+    auto first = upTargets.begin() + upOffsets[a];
+    auto last = upTargets.begin() + upOffsets[a + 1];
+    auto it = lower_bound(first, last, b, [&](int x, int y) { return rank[x] < rank[y]; });
+    return (it != last && *it == b) ? (int)(it - upTargets.begin()) : -1;
+}
+
+/**
+ * @brief Computes the customized weights of every arc from the input times (basic customization).
+ *
+ * The lower triangles of every arc are processed bottom-up.
+ *
+ * @note Time Complexity: O(T), where T is the number of lower triangles of the hierarchy.
+ */
+static void customizeWeights(const CchTopology& topology, CchMetric& metric) {
+    metric.weight = metric.input;
+    auto& weight = metric.weight;
+    for (int i = 0; i < topology.nodeCount(); ++i) {
+        int v = topology.nodeAt(i);
+        int first = topology.firstUpArc(v), last = topology.lastUpArc(v);
+        for (int a = first; a < last; ++a) {
+            if (weight[a] == INT_MAX) continue;
+            int u = topology.upTarget(a);
+            for (int b = a + 1; b < last; ++b) {
+                if (weight[b] == INT_MAX) continue;
+                int arc = topology.findArc(u, topology.upTarget(b));   // existe: vizinhos formam um clique
+                weight[arc] = min(weight[arc], weight[a] + weight[b]);
+            }
+        }
+    }
+}
+
+// Acima de 1/ratio dos arcos afetados, a customização completa é mais rápida do que a parcial
+static const size_t fullCustomizationRatio = 64;
+
+// Arcos visitados por uma customização parcial por cada arco que os arcos alterados afetam
+// diretamente (medido numa grelha de 10k nós: entre 10 e 25 a partir de alguns segmentos)
+static const size_t spreadFactor = 16;
+
+/**
+ * @brief Customizes the hierarchy for the driving times of a graph, with optional closures.
+ *
+ * @param topology The hierarchy topology of `g`.
+ * @param g The graph providing the driving times.
+ * @param avoidNodes Nodes that cannot be entered.
+ * @param avoidSegments Segments that cannot be used, in either direction.
+ * @return The customized metric.
+ *
+ * @note Time Complexity: O(T), where T is the number of lower triangles of the hierarchy.
+ */
+CchMetric customizeCch(const CchTopology& topology, const Graph& g,
+                       const set<int>& avoidNodes,
+                       const set<pair<int, int>>& avoidSegments) {
+    GraphView gv = g.view();
+    int n = topology.nodeCount();
+    CchMetric metric;
+    metric.input.assign(topology.arcCount(), INT_MAX);
+
+    // Tempos dos segmentos reais (o menor, se houver segmentos paralelos)
+    for (int u = 0; u < n; ++u) {
+        for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+            int a = topology.arcOfEdge(e), w = gv.edgeData(e).drivingTime;
+            if (a != -1 && w != -1 && w < metric.input[a]) metric.input[a] = w;
+        }
+    }
+
+    // Cortes: segmentos e todos os arcos dos nós proibidos passam a infinito
+    for (const auto& [a, b] : avoidSegments) {
+        if (a < 0 || b < 0 || a >= n || b >= n) continue;
+        int arc = topology.findArc(a, b);
+        if (arc != -1) metric.input[arc] = INT_MAX;
+    }
+    for (int v : avoidNodes) {
+        if (v < 0 || v >= n) continue;
+        for (int a = topology.firstUpArc(v); a < topology.lastUpArc(v); ++a)
+            metric.input[a] = INT_MAX;
+        for (int i = topology.firstDownArc(v); i < topology.lastDownArc(v); ++i)
+            metric.input[topology.downArc(i)] = INT_MAX;
+    }
+
+    customizeWeights(topology, metric);
+    return metric;
+}
+
+/**
+ * @struct RecustomizeScratch
+ * @brief Per-thread state of a partial customization, so that a call only costs the arcs it visits.
+ *
+ * The arrays have one entry per arc and are reused between calls; an entry belongs to the
+ * current call only if its stamp equals the generation, as in `QueryContext`.
+ */
+struct RecustomizeScratch {
+    vector<unsigned> stamp;
+    vector<int> saved;          // peso do arco antes da chamada
+    vector<char> state;
+    unsigned generation = 0;
+    vector<int> touched;        // arcos visitados pela chamada, pela ordem em que foram visitados
+
+    void prepare(int arcCount) {
+        if ((int)stamp.size() < arcCount) {
+            stamp.assign(arcCount, 0);
+            saved.resize(arcCount);
+            state.resize(arcCount);
+            generation = 0;
+        }
+        if (++generation == 0) {
+            fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+        touched.clear();
+    }
+    bool visited(int arc) const { return stamp[arc] == generation; }
+};
+
+/**
+ * @brief Returns the partial customization state of the calling thread.
+ */
+static RecustomizeScratch& recustomizeScratch() {
+    static thread_local RecustomizeScratch scratch;
+    return scratch;
+}
+
+/**
+ * @brief Estimates how many arcs a partial customization from some arcs will visit.
+ *
+ * Each changed arc reaches directly the arcs it closes a lower triangle with, one per upward
+ * arc of its lower end; the changes then spread upwards, so the arcs actually visited are
+ * about `spreadFactor` times as many.
+ *
+ * @param topology The hierarchy topology.
+ * @param arcs The changed arcs, as (arc, lower end) pairs.
+ * @return The estimated number of arcs visited.
+ *
+ * @note Time Complexity: O(s), where s is the number of arcs.
+ */
+static size_t estimateSpread(const CchTopology& topology, const vector<pair<int, int>>& arcs) {
+    size_t spread = 0;
+    for (auto [arc, low] : arcs)
+        spread += 1 + topology.lastUpArc(low) - topology.firstUpArc(low);
+    return spread * spreadFactor;
+}
+
+/**
+ * @brief Propagates changed input times through the customized weights, visiting only the arcs that depend on them.
+ *
+ * Arcs are processed in increasing rank of their lower end: the arcs of one lower end do not
+ * depend on each other, so each level first gets its final weights, then updates the arcs it
+ * forms a lower triangle with. A decrease just relaxes them; an increase makes an arc be
+ * recomputed from all its lower triangles when the triangle was the one defining its weight.
+ * The visited arcs and their old weights are left in the thread's `recustomizeScratch`.
+ *
+ * @param topology The hierarchy topology.
+ * @param metric The metric; its `input` already holds the new times of `arcs`.
+ * @param arcs The arcs whose input time changed, as (arc, lower end) pairs.
+ * @param limit The maximum number of arcs to visit.
+ * @return False if the limit was reached; the weights are then partly updated (see the scratch).
+ *
+ * @note Time Complexity: O(A * d log d), where A is the number of arcs visited and d the degree.
+ */
+static bool propagateWeights(const CchTopology& topology, CchMetric& metric, const vector<pair<int, int>>& arcs,
+                             size_t limit) {
+    auto& input = metric.input;
+    auto& weight = metric.weight;
+    RecustomizeScratch& scratch = recustomizeScratch();
+    scratch.prepare(topology.arcCount());
+
+    // Arcos pendentes, pela posição da extremidade inferior (só dependem de arcos mais abaixo)
+    enum : char { Relaxed, Recompute };
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> queue;
+    auto touch = [&](int arc, int a, int b, char mark) {
+        if (!scratch.visited(arc)) {
+            scratch.stamp[arc] = scratch.generation;
+            scratch.saved[arc] = weight[arc];
+            scratch.state[arc] = mark;
+            scratch.touched.push_back(arc);
+            queue.push({min(topology.rankOf(a), topology.rankOf(b)), arc});
+        }
+        scratch.state[arc] = max(scratch.state[arc], mark);
+    };
+    // Peso antes da chamada
+    auto previous = [&](int arc) { return scratch.visited(arc) ? scratch.saved[arc] : weight[arc]; };
+
+    for (auto [arc, low] : arcs)
+        touch(arc, low, low, Recompute);
+
+    // Soma de dois pesos, com INT_MAX como infinito
+    auto add = [](int x, int y) { return (x == INT_MAX || y == INT_MAX) ? INT_MAX : x + y; };
+
+    vector<int> level;
+    while (!queue.empty()) {
+        if (scratch.touched.size() > limit) return false;   // antes de fazer o trabalho do nível
+
+        // Todos os arcos que saem do mesmo nó: não dependem uns dos outros
+        int position = queue.top().first;
+        int low = topology.nodeAt(position);
+        level.clear();
+        while (!queue.empty() && queue.top().first == position) {
+            level.push_back(queue.top().second);
+            queue.pop();
+        }
+
+        // 1. Valor final de cada arco; de raiz, o mínimo sobre os triângulos inferiores
+        for (int arc : level) {
+            if (scratch.state[arc] != Recompute) continue;
+            int high = topology.upTarget(arc);
+            int best = input[arc];
+            for (int i = topology.firstDownArc(low); i < topology.lastDownArc(low); ++i) {
+                int other = topology.findArc(topology.downSource(i), high);
+                if (other != -1) best = min(best, add(weight[topology.downArc(i)], weight[other]));
+            }
+            weight[arc] = best;
+        }
+
+        // 2. Triângulos (low, high, z) que os arcos alterados fecham: o arco (high, z) desce por
+        //    relaxação, ou é recalculado de raiz se o triângulo que o definia ficou mais caro
+        for (int arc : level) {
+            if (weight[arc] == scratch.saved[arc]) continue;
+            int high = topology.upTarget(arc);
+            for (int b = topology.firstUpArc(low); b < topology.lastUpArc(low); ++b) {
+                int z = topology.upTarget(b);
+                if (z == high) continue;
+                int target = topology.findArc(high, z);
+                int before = add(scratch.saved[arc], previous(b)), after = add(weight[arc], weight[b]);
+                if (after < weight[target]) {
+                    touch(target, high, z, Relaxed);
+                    weight[target] = after;
+                } else if (after > before && before == previous(target)) {
+                    touch(target, high, z, Recompute);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Updates a metric customized without closures after some driving times of the graph changed.
+ *
+ * @param topology The hierarchy topology of `g`.
+ * @param g The graph, with the new driving times.
+ * @param metric A metric customized for the old times, without closures; updated in place.
+ * @param segments The changed segments, as pairs of nodes.
+ * @return The number of arcs whose customized weight changed.
+ *
+ * @note Time Complexity: O(A * d log d), where A is the number of arcs visited and d the degree; at most O(T).
+ */
+int recustomizeCch(const CchTopology& topology, const Graph& g, CchMetric& metric,
+                   const vector<pair<int, int>>& segments) {
+    GraphView gv = g.view();
+    auto& input = metric.input;
+
+    // Tempo real dos segmentos alterados: o menor dos arcos paralelos, em ambos os sentidos
+    vector<pair<int, int>> arcs;
+    for (const auto& [a, b] : segments) {
+        int arc = topology.findArc(a, b);
+        if (arc == -1) continue;
+        int time = INT_MAX;
+        for (int end : {a, b}) {
+            int other = end == a ? b : a;
+            for (int e = gv.firstEdge(end); e < gv.lastEdge(end); ++e) {
+                int w = gv.edgeData(e).drivingTime;
+                if (gv.target(e) == other && w != -1) time = min(time, w);
+            }
+        }
+        input[arc] = time;
+        arcs.push_back({arc, topology.rankOf(a) < topology.rankOf(b) ? a : b});
+    }
+
+    // Acima desta fração de arcos visitados, a customização completa (sequencial, sem fila) é mais rápida.
+    // Se a estimativa já a ultrapassa, nem se começa a propagação; senão o limite é verificado antes de cada nível.
+    const size_t fullLimit = topology.arcCount() / fullCustomizationRatio;
+    if (estimateSpread(topology, arcs) <= fullLimit && propagateWeights(topology, metric, arcs, fullLimit)) {
+        const RecustomizeScratch& scratch = recustomizeScratch();
+        int changed = 0;
+        for (int arc : scratch.touched) changed += metric.weight[arc] != scratch.saved[arc];
+        return changed;
+    }
+
+    // Pesos anteriores (os que a propagação interrompida já alterou estão no scratch)
+    vector<int> previous(metric.weight);
+    const RecustomizeScratch& scratch = recustomizeScratch();
+    for (int arc : scratch.touched) previous[arc] = scratch.saved[arc];
+    customizeWeights(topology, metric);
+
+    int changed = 0;
+    for (size_t a = 0; a < previous.size(); ++a) changed += metric.weight[a] != previous[a];
+    return changed;
+}
+
+/**
+ * @brief Expands a hierarchy arc into the road segments it stands for.
+ *
+ * An arc whose weight equals its input time is a real segment; otherwise some lower triangle
+ * (m, a, b) matches the weight, and the arc is replaced by (a, m) and (m, b).
+ *
+ * @note Time Complexity: O(p * d log d), where p is the number of segments produced.
+ */
+static void unpackArc(const CchTopology& topology, const CchMetric& metric, int from, int to, vector<int>& path) {
+    vector<pair<int, int>> stack = {{from, to}};
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+
+        int arc = topology.findArc(a, b);
+        int w = metric.weight[arc];
+        if (metric.input[arc] == w) {
+            path.push_back(b);   // segmento original
+            continue;
+        }
+
+        int low = topology.rankOf(a) < topology.rankOf(b) ? a : b;
+        int high = low == a ? b : a;
+        for (int i = topology.firstDownArc(low); i < topology.lastDownArc(low); ++i) {
+            int m = topology.downSource(i);
+            int wa = metric.weight[topology.downArc(i)];
+            int other = topology.findArc(m, high);
+            if (other == -1 || wa == INT_MAX || metric.weight[other] == INT_MAX) continue;
+            if (wa + metric.weight[other] == w) {
+                stack.push_back({m, b});   // (a, m) é desdobrado primeiro
+                stack.push_back({a, m});
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Computes a shortest driving path from a customized hierarchy.
+ *
+ * @param topology The hierarchy topology.
+ * @param metric A metric customized for the query's closures.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @return A vector of node IDs representing the route, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: O(H * d + p * d), where H is the elimination tree height, d the upward degree and p the path length.
+ */
+vector<int> cchShortestPath(const CchTopology& topology, const CchMetric& metric, int s, int t) {
+    if (s < 0 || t < 0 || s == t) return {};
+
+    QueryContext& fwd = threadQueryContext(0);
+    QueryContext& bwd = threadQueryContext(1);
+    fwd.prepare(topology.nodeCount());
+    bwd.prepare(topology.nodeCount());
+
+    // Sobe a árvore de eliminação a partir de cada extremo, relaxando os arcos ascendentes
+    auto climb = [&](QueryContext& ctx, int start) {
+        ctx.update(start, 0, -1);
+        for (int v = start; v != -1; v = topology.parentOf(v)) {
+            int dv = ctx.distance(v);
+            if (dv == INT_MAX) continue;
+            ctx.settle(v);
+            for (int a = topology.firstUpArc(v); a < topology.lastUpArc(v); ++a) {
+                int w = metric.weight[a];
+                int u = topology.upTarget(a);
+                if (w != INT_MAX && ctx.distance(u) > dv + w) ctx.update(u, dv + w, v);
+            }
+        }
+    };
+    climb(fwd, s);
+    climb(bwd, t);
+
+    // Melhor antepassado comum
+    int best = INT_MAX, meet = -1;
+    for (int v = s; v != -1; v = topology.parentOf(v)) {
+        int df = fwd.distance(v), db = bwd.distance(v);
+        if (df == INT_MAX || db == INT_MAX) continue;
+        if (df + db < best) {
+            best = df + db;
+            meet = v;
+        }
+    }
+    if (meet == -1) return {};
+
+    vector<int> up;
+    for (int at = meet; at != -1; at = fwd.parentOf(at))
+        up.push_back(at);
+    reverse(up.begin(), up.end());
+    for (int at = bwd.parentOf(meet); at != -1; at = bwd.parentOf(at))
+        up.push_back(at);
+
+    vector<int> path = {up[0]};
+    for (size_t i = 0; i + 1 < up.size(); ++i)
+        unpackArc(topology, metric, up[i], up[i + 1], path);
+    return path;
+}
+
+/**
+ * @brief Computes a shortest driving path with closures from a metric customized without them.
+ *
+ * @param topology The hierarchy topology.
+ * @param metric The metric customized without closures.
+ * @param s The node ID of the starting location (it may be left even if it is closed).
+ * @param t The node ID of the destination location.
+ * @param avoidNodes Nodes that cannot be entered.
+ * @param avoidSegments Segments that cannot be used, in either direction.
+ * @param limit The maximum number of arcs the closures may affect.
+ * @param path Receives the route, or an empty vector if there is none.
+ * @return False if the closures affect more than `limit` arcs; `path` is then left empty.
+ *
+ * @note Time Complexity: O(A * d log d) for the A affected arcs, plus the query; O(arcs) once per thread and metric.
+ */
+bool cchRestrictedPath(const CchTopology& topology, const shared_ptr<const CchMetric>& metric, int s, int t,
+                       const set<int>& avoidNodes, const set<pair<int, int>>& avoidSegments, size_t limit,
+                       vector<int>& path) {
+    path.clear();
+    int n = topology.nodeCount();
+    if (s < 0 || t < 0 || s >= n || t >= n || avoidNodes.count(t)) return true;
+
+    // Arcos fechados, como (arco, extremidade inferior); a origem pode ser deixada mesmo que esteja na lista
+    vector<pair<int, int>> closed;
+    auto lowEnd = [&](int a, int b) { return topology.rankOf(a) < topology.rankOf(b) ? a : b; };
+    for (const auto& [a, b] : avoidSegments) {
+        if (a < 0 || b < 0 || a >= n || b >= n) continue;
+        int arc = topology.findArc(a, b);
+        if (arc != -1) closed.push_back({arc, lowEnd(a, b)});
+    }
+    for (int v : avoidNodes) {
+        if (v < 0 || v >= n || v == s) continue;
+        for (int a = topology.firstUpArc(v); a < topology.lastUpArc(v); ++a)
+            closed.push_back({a, v});
+        for (int i = topology.firstDownArc(v); i < topology.lastDownArc(v); ++i)
+            closed.push_back({topology.downArc(i), topology.downSource(i)});
+    }
+    if (estimateSpread(topology, closed) > limit) return false;
+
+    // Cópia da métrica por thread, feita uma vez por métrica; cada pedido desfaz as suas alterações
+    static thread_local shared_ptr<const CchMetric> base;
+    static thread_local CchMetric local;
+    if (base != metric) {
+        local = *metric;
+        base = metric;
+    }
+
+    vector<pair<int, int>> changed;   // (arco, tempo anterior) das entradas fechadas
+    vector<pair<int, int>> seeds;
+    for (auto [arc, low] : closed) {
+        if (local.input[arc] == INT_MAX) continue;   // já fechado (ou repetido)
+        changed.push_back({arc, local.input[arc]});
+        local.input[arc] = INT_MAX;
+        seeds.push_back({arc, low});
+    }
+
+    bool within = propagateWeights(topology, local, seeds, limit);
+    if (within) path = cchShortestPath(topology, local, s, t);
+
+    const RecustomizeScratch& scratch = recustomizeScratch();
+    for (int arc : scratch.touched) local.weight[arc] = scratch.saved[arc];
+    for (auto [arc, time] : changed) local.input[arc] = time;
+    return within;
+}
@@ -0,0 +1,171 @@
+#ifndef CCH_HPP
+#define CCH_HPP
+
+#include <vector>
+#include <set>
+#include <utility>
+#include <memory>
+#include "graph.h"
+#include "flatarray.h"
+
+struct Network;
+
+using namespace std;
+
+/**
+ * @class CchTopology
+ * @brief Metric-independent part of a Customizable Contraction Hierarchy.
+ *
+ * Nodes are ranked by a nested-dissection order computed from the topology alone (every
+ * segment, drivable or not), and the graph is completed so that the upward neighbours of each
+ * node form a clique. That structure never changes when travel times or closures change:
+ * only the metric (`CchMetric`) has to be customized.
+ */
+class CchTopology {
+private:
+    FlatArray<int> rank;        // nó -> posição na ordem de dissecção
+    FlatArray<int> byRank;      // posição -> nó
+    FlatArray<int> etreeParent; // pai na árvore de eliminação (-1 nas raízes)
+    FlatArray<int> upOffsets;   // arcos ascendentes de cada nó, ordenados pela ordem do destino
+    FlatArray<int> upTargets;
+    FlatArray<int> downOffsets; // arcos que chegam a cada nó vindos de nós inferiores
+    FlatArray<int> downSources;
+    FlatArray<int> downArcs;    // ID do arco ascendente correspondente
+    FlatArray<int> inputArc;    // arco do Graph -> arco da hierarquia (-1 para lacetes)
+
+    // O snapshot guarda e mapeia os arrays diretamente
+    friend bool saveSnapshot(const Network& net, const string& path);
+    friend bool loadSnapshot(const string& path, Network& net, bool verify);
+
+public:
+    CchTopology() = default;
+
+    /**
+     * @brief Builds the topology of a graph.
+     *
+     * @note Time Complexity: O(V log V + E) for the ordering plus the size of the chordal completion.
+     */
+    explicit CchTopology(const Graph& g);
+
+    int nodeCount() const { return (int)rank.size(); }
+    int arcCount() const { return (int)upTargets.size(); }
+    int rankOf(int node) const { return rank[node]; }
+    int nodeAt(int position) const { return byRank[position]; }
+    int parentOf(int node) const { return etreeParent[node]; }
+    int firstUpArc(int node) const { return upOffsets[node]; }
+    int lastUpArc(int node) const { return upOffsets[node + 1]; }
+    int upTarget(int arc) const { return upTargets[arc]; }
+    int firstDownArc(int node) const { return downOffsets[node]; }
+    int lastDownArc(int node) const { return downOffsets[node + 1]; }
+    int downSource(int index) const { return downSources[index]; }
+    int downArc(int index) const { return downArcs[index]; }
+    int arcOfEdge(int graphEdge) const { return inputArc[graphEdge]; }
+
+    /**
+     * @brief Finds the hierarchy arc between two nodes, in either order.
+     *
+     * @return The arc ID, or -1 if the nodes are not adjacent in the hierarchy.
+     *
+     * @note Time Complexity: O(log d), where d is the upward degree of the lower-ranked node.
+     */
+    int findArc(int a, int b) const;
+};
+
+/**
+ * @struct CchMetric
+ * @brief Driving times of the arcs of a CchTopology, after customization.
+ *
+ * `input` holds the time of the road segment behind each arc (INT_MAX if the arc is a fill-in,
+ * is not drivable or is closed); `weight` holds the shortest time between the two ends through
+ * lower-ranked nodes, which is what queries use.
+ */
+struct CchMetric {
+    vector<int> input;
+    vector<int> weight;
+};
+
+/**
+ * @brief Customizes the hierarchy for the driving times of a graph, with optional closures.
+ *
+ * Closed nodes and segments get an infinite time, and the lower triangles of every arc are
+ * then processed bottom-up. The topology is untouched, so this can run once per incident; it
+ * costs the whole hierarchy, so per request use `cchRestrictedPath` instead.
+ *
+ * @param topology The hierarchy topology of `g`.
+ * @param g The graph providing the driving times.
+ * @param avoidNodes Nodes that cannot be entered (may be empty).
+ * @param avoidSegments Segments that cannot be used, in either direction (may be empty).
+ * @return The customized metric.
+ *
+ * @note Time Complexity: O(T), where T is the number of lower triangles of the hierarchy.
+ */
+CchMetric customizeCch(const CchTopology& topology, const Graph& g,
+    const set<int>& avoidNodes,
+    const set<pair<int, int>>& avoidSegments);
+
+/**
+ * @brief Updates a metric customized without closures after some driving times of the graph changed.
+ *
+ * Only the arcs that depend on a changed segment are visited, in increasing rank of their lower
+ * end: the input time of every changed segment is read again from the graph, and an arc whose
+ * weight changes updates the arcs it forms a lower triangle with. A decrease just relaxes them;
+ * an increase makes an arc be recomputed from all its lower triangles when the triangle was the
+ * one defining its weight. The result equals a full `customizeCch` of the updated graph. When
+ * the change would spread to more than 1/64 of the arcs, the weights are recomputed by the full
+ * bottom-up pass instead, which is then faster: the spread is estimated up front from the upward
+ * degree of the changed arcs, so large updates go straight to the full pass, and the propagation
+ * also gives up for it before any level that would exceed the limit.
+ *
+ * @param topology The hierarchy topology of `g`.
+ * @param g The graph, with the new driving times.
+ * @param metric A metric customized for the old times, without closures; updated in place.
+ * @param segments The changed segments, as pairs of nodes.
+ * @return The number of arcs whose customized weight changed.
+ *
+ * @note Time Complexity: O(A * d log d), where A is the number of arcs visited and d the degree; at most O(T).
+ */
+int recustomizeCch(const CchTopology& topology, const Graph& g, CchMetric& metric,
+    const vector<pair<int, int>>& segments);
+
+/**
+ * @brief Computes a shortest driving path with closures from a metric customized without them.
+ *
+ * Closures only make arcs slower, so instead of customizing the whole hierarchy again, the
+ * closed arcs get an infinite input time and the increase is propagated upward as in
+ * `recustomizeCch`, on a per-thread copy of the metric; the query then runs on the copy and
+ * the visited arcs are restored. The copy is made once per thread and metric. When the
+ * closures would affect more than `limit` arcs (estimated before any work, then checked per
+ * level), nothing is computed and the caller should search the graph instead.
+ *
+ * @param topology The hierarchy topology.
+ * @param metric The metric customized without closures.
+ * @param source The starting node (it may be left even if it is closed).
+ * @param dest The destination node.
+ * @param avoidNodes Nodes that cannot be entered (may be empty).
+ * @param avoidSegments Segments that cannot be used, in either direction (may be empty).
+ * @param limit The maximum number of arcs the closures may affect.
+ * @param path Receives the route, or an empty vector if there is none.
+ * @return False if the closures affect more than `limit` arcs; `path` is then left empty.
+ *
+ * @note Time Complexity: O(A * d log d) for the A affected arcs, plus the query; O(arcs) once per thread and metric.
+ */
+bool cchRestrictedPath(const CchTopology& topology, const shared_ptr<const CchMetric>& metric, int source, int dest,
+    const set<int>& avoidNodes, const set<pair<int, int>>& avoidSegments, size_t limit, vector<int>& path);
+
+/**
+ * @brief Computes a shortest driving path from a customized hierarchy.
+ *
+ * Walks the elimination tree from both ends, relaxing upward arcs, and joins the two halves at
+ * the best common ancestor; shortcuts are unpacked through their lower triangles.
+ *
+ * @param topology The hierarchy topology.
+ * @param metric A metric customized for the query's closures.
+ * @param source The starting node (it may be left even if it is closed).
+ * @param dest The destination node.
+ * @return A vector of node IDs representing the path, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: O(H * d + p * d), where H is the elimination tree height, d the upward degree and p the path length.
+ */
+vector<int> cchShortestPath(const CchTopology& topology, const CchMetric& metric, int source, int dest);
+
+#endif
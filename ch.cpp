@@ -0,0 +1,276 @@
+#include "ch.h"
+#include "querycontext.h"
+#include <algorithm>
+#include <climits>
+#include <tuple>
+
+/**
+ * @brief Finds the upward arc between two nodes, in either order.
+ *
+ * @param a One end of the arc.
+ * @param b The other end of the arc.
+ * @return The arc index, or -1 if the nodes are not adjacent in the hierarchy.
+ *
+ * @note Time Complexity: O(d), where d is the upward degree of the lower-ranked node.
+ */
+int ContractionHierarchy::findArc(int a, int b) const {
+    if (rank[a] > rank[b]) swap(a, b);
+    for (int i = offsets[a]; i < offsets[a + 1]; ++i) {
+        if (arcs[i].to == b) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Expands an upward-search path into the road segments it stands for.
+ *
+ * Each shortcut (a, b) through `m` is replaced by (a, m) and (m, b), until only original
+ * segments are left. An explicit stack avoids deep recursion on long shortcuts.
+ *
+ * @param nodes Consecutive nodes of the path, each pair joined by a hierarchy arc.
+ * @return The unpacked path.
+ *
+ * @note Time Complexity: O(p * d), where p is the length of the unpacked path and d the upward degree.
+ */
+vector<int> ContractionHierarchy::unpack(const vector<int>& nodes) const {
+    vector<int> path;
+    if (nodes.empty()) return path;
+    path.push_back(nodes[0]);
+
+    vector<pair<int, int>> stack;
+    for (size_t i = nodes.size() - 1; i > 0; --i)
+        stack.push_back({nodes[i - 1], nodes[i]});
+
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+
+        int middle = arcs[findArc(a, b)].middle;
+        if (middle == -1) {
+            path.push_back(b);       // segmento original
+        } else {
+            stack.push_back({middle, b});   // (a, middle) é desdobrado primeiro
+            stack.push_back({a, middle});
+        }
+    }
+    return path;
+}
+
+/**
+ * @brief Adds an arc to a node's adjacency during contraction, or improves an existing one.
+ *
+ * @note Time Complexity: O(d), where d is the current degree of the node.
+ */
+static void addOrImprove(vector<ChArc>& adj, int to, int weight, int middle) {
+    for (auto& a : adj) {
+        if (a.to == to) {
+            if (weight < a.weight) {
+                a.weight = weight;
+                a.middle = middle;
+            }
+            return;
+        }
+    }
+    adj.push_back({to, weight, middle});
+}
+
+/**
+ * @brief Builds a Contraction Hierarchy over the driving times of a graph.
+ *
+ * @param g The graph.
+ * @return The hierarchy.
+ *
+ * @note Time Complexity: roughly O(V * d^2 * W), where d is the degree during contraction and W the cost of a (bounded) witness search.
+ */
+ContractionHierarchy buildContractionHierarchy(const Graph& g) {
+    const int maxSettled = 500;   // limite das pesquisas de testemunhas (mais atalhos, nunca incorreto)
+
+    GraphView gv = g.view();
+    int n = gv.nodeCount();
+
+    // Grafo restante (não orientado): arcos de condução sem duplicados nem lacetes
+    vector<vector<ChArc>> adj(n);
+    for (int u = 0; u < n; ++u) {
+        for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+            int v = gv.target(e), w = gv.edgeData(e).drivingTime;
+            if (w == -1 || v == u) continue;
+            addOrImprove(adj[u], v, w, -1);
+        }
+    }
+
+    QueryContext witness;
+    witness.prepare(n);
+
+    // Distâncias de `source` no grafo restante sem passar por `skip`, até `limit`
+    auto witnessSearch = [&](int source, int skip, int limit) {
+        witness.reset();
+        witness.block(skip);
+        auto& pq = witness.heap();
+        witness.update(source, 0, -1);
+        pq.push_back({0, source});
+        int settled = 0;
+        while (!pq.empty()) {
+            pop_heap(pq.begin(), pq.end(), greater<>());
+            auto [d, u] = pq.back();
+            pq.pop_back();
+            if (witness.isSettled(u)) continue;
+            witness.settle(u);
+            if (d > limit || ++settled > maxSettled) break;
+            for (const auto& a : adj[u]) {
+                if (witness.isBlocked(a.to)) continue;
+                if (witness.distance(a.to) > d + a.weight) {
+                    witness.update(a.to, d + a.weight, u);
+                    pq.push_back({d + a.weight, a.to});
+                    push_heap(pq.begin(), pq.end(), greater<>());
+                }
+            }
+        }
+    };
+
+    // Atalhos necessários para contrair v: (u, x, peso)
+    vector<tuple<int, int, int>> shortcuts;
+    auto simulate = [&](int v) {
+        shortcuts.clear();
+        const auto& nb = adj[v];
+        int maxOut = 0;
+        for (const auto& a : nb) maxOut = max(maxOut, a.weight);
+
+        for (size_t i = 0; i < nb.size(); ++i) {
+            witnessSearch(nb[i].to, v, nb[i].weight + maxOut);
+            for (size_t j = i + 1; j < nb.size(); ++j) {
+                int need = nb[i].weight + nb[j].weight;
+                if (witness.distance(nb[j].to) > need)
+                    shortcuts.emplace_back(nb[i].to, nb[j].to, need);
+            }
+        }
+        return (int)shortcuts.size();
+    };
+
+    vector<int> deletedNeighbours(n, 0);
+    auto priority = [&](int v) {
+        return simulate(v) - (int)adj[v].size() + deletedNeighbours[v];
+    };
+
+    vector<pair<int, int>> pq;
+    for (int v = 0; v < n; ++v)
+        pq.push_back({priority(v), v});
+    make_heap(pq.begin(), pq.end(), greater<>());
+
+    vector<int> rank(n, -1);
+    vector<vector<ChArc>> up(n);
+    int next = 0;
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), greater<>());
+        int v = pq.back().second;
+        pq.pop_back();
+        if (rank[v] != -1) continue;
+
+        // Atualização preguiçosa: se a prioridade piorou, volta para a fila
+        int p = priority(v);
+        if (!pq.empty() && p > pq.front().first) {
+            pq.push_back({p, v});
+            push_heap(pq.begin(), pq.end(), greater<>());
+            continue;
+        }
+
+        // Contrai v (priority já deixou em `shortcuts` os atalhos de v): os vizinhos restantes têm ordem superior
+        rank[v] = next++;
+        up[v] = adj[v];
+        for (const auto& a : adj[v]) {
+            auto& other = adj[a.to];
+            other.erase(remove_if(other.begin(), other.end(), [&](const ChArc& b) { return b.to == v; }), other.end());
+            deletedNeighbours[a.to]++;
+        }
+        for (auto [a, b, w] : shortcuts) {
+            addOrImprove(adj[a], b, w, v);
+            addOrImprove(adj[b], a, w, v);
+        }
+        adj[v].clear();
+        adj[v].shrink_to_fit();
+    }
+
+    // Grafo ascendente em formato CSR
+    vector<int> offsets(n + 1, 0);
+    for (int v = 0; v < n; ++v)
+        offsets[v + 1] = offsets[v] + (int)up[v].size();
+    vector<ChArc> arcs;
+    arcs.reserve(offsets[n]);
+    for (int v = 0; v < n; ++v)
+        arcs.insert(arcs.end(), up[v].begin(), up[v].end());
+
+    return ContractionHierarchy(std::move(rank), std::move(offsets), std::move(arcs));
+}
+
+/**
+ * @brief Computes a shortest driving path with a bidirectional upward search.
+ *
+ * Both searches only follow arcs towards higher-ranked nodes and stop once their smallest key
+ * reaches the best meeting distance. The two halves of the path are joined at the meeting
+ * node and their shortcuts unpacked.
+ *
+ * @param ch The hierarchy.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @return A vector of node IDs representing the route, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: O(U * log U + p), where U is the size of the upward search spaces and p the length of the path.
+ */
+vector<int> chShortestPath(const ContractionHierarchy& ch, int s, int t) {
+    if (s < 0 || t < 0 || s == t) return {};
+
+    QueryContext& fwd = threadQueryContext(0);
+    QueryContext& bwd = threadQueryContext(1);
+    fwd.prepare(ch.nodeCount());
+    bwd.prepare(ch.nodeCount());
+
+    fwd.update(s, 0, -1);
+    fwd.heap().push_back({0, s});
+    bwd.update(t, 0, -1);
+    bwd.heap().push_back({0, t});
+
+    int best = INT_MAX, meet = -1;
+    while (true) {
+        int fTop = fwd.heap().empty() ? INT_MAX : fwd.heap().front().first;
+        int bTop = bwd.heap().empty() ? INT_MAX : bwd.heap().front().first;
+        if (min(fTop, bTop) >= best) break;   // nenhum dos lados pode melhorar
+
+        bool forward = fTop <= bTop;
+        QueryContext& ctx = forward ? fwd : bwd;
+        QueryContext& other = forward ? bwd : fwd;
+        auto& pq = ctx.heap();
+
+        pop_heap(pq.begin(), pq.end(), greater<>());
+        int u = pq.back().second;
+        pq.pop_back();
+        if (ctx.isSettled(u)) continue;
+        ctx.settle(u);
+
+        int du = ctx.distance(u);
+        int rest = other.distance(u);
+        if (rest != INT_MAX && du + rest < best) {
+            best = du + rest;
+            meet = u;
+        }
+
+        for (int i = ch.firstArc(u); i < ch.lastArc(u); ++i) {
+            const ChArc& a = ch.arc(i);
+            if (ctx.distance(a.to) > du + a.weight) {
+                ctx.update(a.to, du + a.weight, u);
+                pq.push_back({du + a.weight, a.to});
+                push_heap(pq.begin(), pq.end(), greater<>());
+            }
+        }
+    }
+
+    if (meet == -1) return {};
+
+    // s -> meet pela árvore da frente, meet -> t pela de trás
+    vector<int> nodes;
+    for (int at = meet; at != -1; at = fwd.parentOf(at))
+        nodes.push_back(at);
+    reverse(nodes.begin(), nodes.end());
+    for (int at = bwd.parentOf(meet); at != -1; at = bwd.parentOf(at))
+        nodes.push_back(at);
+
+    return ch.unpack(nodes);
+}
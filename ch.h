@@ -0,0 +1,107 @@
+#ifndef CH_HPP
+#define CH_HPP
+
+#include <vector>
+#include "graph.h"
+#include "flatarray.h"
+
+using namespace std;
+
+/**
+ * @struct ChArc
+ * @brief An upward arc of a contraction hierarchy.
+ *
+ * `middle` is -1 for an original road segment; for a shortcut it is the contracted node the
+ * shortcut bypasses, so the shortcut unpacks into (from, middle) + (middle, to).
+ */
+struct ChArc {
+    int to;
+    int weight;
+    int middle;
+};
+
+/**
+ * @class ContractionHierarchy
+ * @brief Contraction Hierarchy over the driving times of a graph.
+ *
+ * Nodes are ranked by contraction order. Driving times are symmetric, so a single upward
+ * graph (arcs from each node to its higher-ranked neighbours, shortcuts included) serves
+ * both the forward and the backward search of a query.
+ */
+class ContractionHierarchy {
+private:
+    FlatArray<int> rank;     // nó -> posição na ordem de contração
+    FlatArray<int> offsets;  // offsets[u]..offsets[u+1] são os arcos ascendentes de u
+    FlatArray<ChArc> arcs;
+
+public:
+    ContractionHierarchy() = default;
+
+    /**
+     * @brief Creates a hierarchy from its node ranks and upward arcs in CSR form (owned or views).
+     */
+    ContractionHierarchy(FlatArray<int> rank, FlatArray<int> offsets, FlatArray<ChArc> arcs)
+        : rank(std::move(rank)), offsets(std::move(offsets)), arcs(std::move(arcs)) {}
+
+    int nodeCount() const { return (int)rank.size(); }
+    int arcCount() const { return (int)arcs.size(); }
+    int rankOf(int node) const { return rank[node]; }
+    int firstArc(int node) const { return offsets[node]; }
+    int lastArc(int node) const { return offsets[node + 1]; }
+    const ChArc& arc(int index) const { return arcs[index]; }
+
+    const FlatArray<int>& ranks() const { return rank; }
+    const FlatArray<int>& arcOffsets() const { return offsets; }
+    const FlatArray<ChArc>& upwardArcs() const { return arcs; }
+
+    /**
+     * @brief Finds the upward arc between two nodes, in either order.
+     *
+     * @return The arc index, or -1 if the nodes are not adjacent in the hierarchy.
+     *
+     * @note Time Complexity: O(d), where d is the upward degree of the lower-ranked node.
+     */
+    int findArc(int a, int b) const;
+
+    /**
+     * @brief Expands an upward-search path into the road segments it stands for.
+     *
+     * @param nodes Consecutive nodes of the path, each pair joined by a hierarchy arc.
+     * @return The same path with every shortcut replaced by the nodes it bypasses.
+     *
+     * @note Time Complexity: O(p * d), where p is the length of the unpacked path.
+     */
+    vector<int> unpack(const vector<int>& nodes) const;
+};
+
+/**
+ * @brief Builds a Contraction Hierarchy over the driving times of a graph.
+ *
+ * Segments without a driving time (-1) are ignored. Nodes are contracted in order of edge
+ * difference (shortcuts added minus arcs removed, plus the number of already contracted
+ * neighbours), kept up to date lazily. A shortcut is only added when a bounded witness search
+ * finds no path at least as short that avoids the contracted node.
+ *
+ * @param g The graph.
+ * @return The hierarchy.
+ *
+ * @note Time Complexity: roughly O(V * d^2 * W), where d is the degree during contraction and W the cost of a (bounded) witness search.
+ */
+ContractionHierarchy buildContractionHierarchy(const Graph& g);
+
+/**
+ * @brief Computes a shortest driving path with a bidirectional upward search in a hierarchy.
+ *
+ * Returns a path with the same driving time as `dijkstraShortestPath`; shortcuts are unpacked,
+ * so the path lists the same kind of node IDs as the other engines.
+ *
+ * @param ch The hierarchy.
+ * @param source The starting node.
+ * @param dest The destination node.
+ * @return A vector of node IDs representing the path, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: O(U * log U + p), where U is the size of the upward search spaces and p the length of the path.
+ */
+vector<int> chShortestPath(const ContractionHierarchy& ch, int source, int dest);
+
+#endif
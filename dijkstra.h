@@ -0,0 +1,73 @@
+#ifndef DIJKSTRA_HPP
+#define DIJKSTRA_HPP
+
+#include <set>
+#include <utility>
+#include <climits>
+#include "graph.h"
+#include "querycontext.h"
+#include "pqueue.h"
+
+using namespace std;
+
+/**
+ * @brief Priority queue used by the Dijkstra engine unless another one is requested.
+ *
+ * Travel times are small non-negative integers (minutes), so the keys popped by Dijkstra never
+ * decrease and a bucket queue beats a comparison heap.
+ */
+using DefaultQueue = DialQueue;
+
+/**
+ * @brief Runs Dijkstra's algorithm from a source node (one-to-many).
+ *
+ * The search state lives in `ctx`, which must have been prepared for the graph; nodes blocked
+ * in the context are never entered. On return the context holds the distances and parents of
+ * every reachable node (or of the nodes settled before it stopped, when given a target or a
+ * limit). The queue is chosen at compile time: `BinaryHeap`, `DaryHeap<D>`,
+ * `DialQueue` or `RadixHeap` (see pqueue.h); each thread keeps one queue per type.
+ *
+ * @tparam Queue The priority queue type.
+ * @param gv The read-only view of the graph.
+ * @param ctx The query workspace, already prepared (and with any blocked nodes marked).
+ * @param s The node ID of the source.
+ * @param avoidSegments Segments that cannot be used, in either direction.
+ * @param time The travel time to minimize (`&EdgeData::drivingTime` or `&EdgeData::walkingTime`); arcs where it is -1 are skipped.
+ * @param target A node whose settling ends the search, or -1 to search the whole graph.
+ * @param limit The search ends before settling a node at this distance or more.
+ *
+ * @note Time Complexity: O(E + V * log V) with a binary heap; O(E + V + D) with `DialQueue`, where D is the largest distance.
+ */
+template <class Queue = DefaultQueue>
+void dijkstraSearch(GraphView gv, QueryContext& ctx, int s, const set<pair<int, int>>& avoidSegments,
+                    int EdgeData::*time = &EdgeData::drivingTime, int target = -1, int limit = INT_MAX) {
+    static thread_local Queue pq;   // reutilizada entre consultas da mesma thread
+    pq.clear();
+    ctx.update(s, 0, -1);
+    pq.push(0, s);
+
+    while (!pq.empty()) {
+        int u = pq.pop().second;
+        if (ctx.isSettled(u)) continue;
+
+        int du = ctx.distance(u);
+        if (du >= limit) break;   // as chaves seguintes nunca são menores
+        ctx.settle(u);
+        if (u == target) break;
+
+        for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+            int v = gv.target(e);
+            int w = gv.edgeData(e).*time;
+            if (w == -1) continue; // ignora se não há tempo neste modo
+            if (ctx.isBlocked(v)) continue;
+            if (!avoidSegments.empty() && (avoidSegments.count({u, v}) || avoidSegments.count({v, u}))) continue;
+
+            if (ctx.distance(v) > du + w) {
+                ctx.update(v, du + w, u);
+                pq.push(du + w, v);
+            }
+        }
+    }
+}
+
+#endif
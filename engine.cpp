@@ -0,0 +1,82 @@
+#include "engine.h"
+#include "route.h"
+#include "parser.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Parses an engine name as written in batch files.
+ *
+ * @param name The engine name.
+ * @param engine Receives the engine if the name is valid.
+ * @return True if the name is a known engine.
+ *
+ * @note Time Complexity: O(k), where k is the length of the name.
+ */
+bool parseEngine(const string& name, Engine& engine) {
+    string key = cleanCode(name);
+    key.erase(remove(key.begin(), key.end(), '\r'), key.end());
+
+    if (key == "dijkstra") engine = Engine::Dijkstra;
+    else if (key == "bidirectional") engine = Engine::Bidirectional;
+    else if (key == "alt") engine = Engine::ALT;
+    else if (key == "ch") engine = Engine::CH;
+    else if (key == "cch") engine = Engine::CCH;
+    else return false;
+    return true;
+}
+
+// Arcos da CCH que os cortes de um pedido podem afetar, em fração dos arcos do grafo: acima
+// disto a recustomização parcial custa mais do que uma pesquisa de Dijkstra (medido numa grelha de 10k nós)
+static const int cchClosureRatio = 256;
+
+/**
+ * @brief Computes a shortest driving path with the selected engine.
+ *
+ * @param net The network representing the locations and edges.
+ * @param engine The algorithm to use.
+ * @param source The node ID of the starting location.
+ * @param dest The node ID of the destination location.
+ * @param avoidNodes A set of nodes to avoid in the route.
+ * @param avoidSegments A set of segments to avoid in the route.
+ * @return A vector of node IDs representing the route, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: that of the selected engine.
+ */
+vector<int> drivingRoute(const Network& net, Engine engine, int source, int dest,
+                         const set<int>& avoidNodes,
+                         const set<pair<int, int>>& avoidSegments) {
+    const Graph& g = net.graph;
+    switch (engine) {
+        case Engine::CCH: {
+            if (!net.cch) return dijkstraRestricted(g, source, dest, avoidNodes, avoidSegments);
+            if (avoidNodes.empty() && avoidSegments.empty() && net.cchMetric)
+                return cchShortestPath(*net.cch, *net.cchMetric, source, dest);
+
+            // Só os arcos afetados pelos cortes são recustomizados; se forem demasiados, Dijkstra é mais rápido
+            vector<int> path;
+            if (net.cchMetric && cchRestrictedPath(*net.cch, net.cchMetric, source, dest, avoidNodes, avoidSegments,
+                                                   g.edgeCount() / cchClosureRatio, path))
+                return path;
+            return dijkstraRestricted(g, source, dest, avoidNodes, avoidSegments);
+        }
+        case Engine::CH:
+            // A hierarquia é estática: com restrições usa-se Dijkstra
+            if (net.ch && avoidNodes.empty() && avoidSegments.empty())
+                return chShortestPath(*net.ch, source, dest);
+            // Sem CH (descartada por atualizações de tempos) a CCH recustomizada responde no seu lugar
+            if (!net.ch && net.cch && net.cchMetric && avoidNodes.empty() && avoidSegments.empty())
+                return cchShortestPath(*net.cch, *net.cchMetric, source, dest);
+            return dijkstraRestricted(g, source, dest, avoidNodes, avoidSegments);
+        case Engine::ALT:
+            if (net.landmarks)
+                return altShortestPath(g, *net.landmarks, source, dest, avoidNodes, avoidSegments);
+            return dijkstraRestricted(g, source, dest, avoidNodes, avoidSegments);
+        case Engine::Bidirectional:
+            return bidirectionalDijkstra(g, source, dest, avoidNodes, avoidSegments);
+        case Engine::Dijkstra:
+        default:
+            return dijkstraRestricted(g, source, dest, avoidNodes, avoidSegments);
+    }
+}
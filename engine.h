@@ -0,0 +1,56 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+#include <utility>
+#include "network.h"
+
+/**
+ * @enum Engine
+ * @brief Shortest-path algorithms that can answer point-to-point driving queries.
+ */
+enum class Engine {
+    Dijkstra,        ///< Unidirectional Dijkstra (`dijkstraRestricted`).
+    Bidirectional,   ///< Bidirectional Dijkstra (`bidirectionalDijkstra`).
+    ALT,             ///< A* with landmark lower bounds (`altShortestPath`); needs `Network::landmarks`.
+    CH,              ///< Contraction Hierarchies (`chShortestPath`); needs `Network::ch` (else the CCH metric), unrestricted queries only.
+    CCH              ///< Customizable Contraction Hierarchies (`cchShortestPath`); needs `Network::cch`, closures applied with `cchRestrictedPath`.
+};
+
+/**
+ * @brief Parses an engine name as written in batch files ("dijkstra", "bidirectional", "alt", "ch" or "cch").
+ *
+ * @param name The engine name (case-sensitive, surrounding spaces ignored).
+ * @param engine Receives the engine if the name is valid.
+ * @return True if the name is a known engine.
+ *
+ * @note Time Complexity: O(k), where k is the length of the name.
+ */
+bool parseEngine(const std::string& name, Engine& engine);
+
+/**
+ * @brief Computes a shortest driving path with the selected engine.
+ *
+ * All engines return a path of minimum driving time that avoids the given nodes and segments;
+ * they may differ only in how equal-cost ties are resolved. Engines whose preprocessing is
+ * missing from the network, or that cannot honour the avoid lists (CH), fall back to Dijkstra.
+ * The CCH engine applies the avoid lists to the network's metric with `cchRestrictedPath` and
+ * also falls back to Dijkstra when they affect too many arcs for that to be faster.
+ *
+ * @param net The network in which to find the path.
+ * @param engine The algorithm to use.
+ * @param source The starting node.
+ * @param dest The destination node.
+ * @param avoidNodes A set of nodes to avoid (may be empty).
+ * @param avoidSegments A set of edges to avoid (may be empty).
+ * @return A vector of node IDs representing the path, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: that of the selected engine.
+ */
+std::vector<int> drivingRoute(const Network& net, Engine engine, int source, int dest,
+    const std::set<int>& avoidNodes,
+    const std::set<std::pair<int, int>>& avoidSegments);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef FLATARRAY_HPP
+#define FLATARRAY_HPP
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @class FlatArray
+ * @brief Contiguous array that either owns its elements or views memory owned elsewhere.
+ *
+ * Arrays built at run time own a vector; arrays loaded from a snapshot point straight into
+ * the mapped file, so loading copies nothing. Reads go through the same pointer either way.
+ * A view is only valid while the memory it points into is alive (see `Network::snapshot`).
+ * Arrays are read-only except through `mutableData`, which turns a view into a private copy.
+ */
+template <class T>
+class FlatArray {
+private:
+    vector<T> owned;
+    const T* items = nullptr;
+    size_t count = 0;
+
+public:
+    FlatArray() = default;
+
+    /**
+     * @brief Takes ownership of the elements of a vector.
+     */
+    FlatArray(vector<T>&& values) : owned(std::move(values)), items(owned.data()), count(owned.size()) {}
+
+    /**
+     * @brief Copies the elements of a vector.
+     */
+    FlatArray(const vector<T>& values) : owned(values), items(owned.data()), count(owned.size()) {}
+
+    /**
+     * @brief Creates a view of elements owned elsewhere.
+     */
+    static FlatArray view(const T* data, size_t size) {
+        FlatArray array;
+        array.items = data;
+        array.count = size;
+        return array;
+    }
+
+    FlatArray(const FlatArray& other) : owned(other.owned), items(other.items), count(other.count) {
+        if (!owned.empty()) items = owned.data();
+    }
+
+    FlatArray(FlatArray&& other) noexcept
+        : owned(std::move(other.owned)), items(other.items), count(other.count) {
+        other.items = nullptr;
+        other.count = 0;
+    }
+
+    FlatArray& operator=(FlatArray other) noexcept {
+        owned.swap(other.owned);
+        items = other.items;
+        count = other.count;
+        return *this;
+    }
+
+    /**
+     * @brief Returns the elements for writing; a view is first copied into owned storage.
+     *
+     * Pointers taken earlier (e.g. by a GraphView) keep pointing to the old elements of a view.
+     *
+     * @note Time Complexity: O(n) the first time for a view, O(1) otherwise.
+     */
+    T* mutableData() {
+        if (owned.data() != items || owned.size() != count) {
+            owned.assign(items, items + count);
+            items = owned.data();
+        }
+        return owned.data();
+    }
+
+    const T& operator[](size_t i) const { return items[i]; }
+    const T* data() const { return items; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+};
+
+#endif
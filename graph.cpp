@@ -1,36 +1,154 @@
 #include "graph.h"
+#include "threadpool.h"
+#include <algorithm>
 #include <iostream>
 
 /**
- * @brief Adds an edge between two nodes (bidirectional) with driving and walking times.
+ * @brief Builds the CSR arrays on a pool.
  *
- * This function creates an edge in both directions between the specified nodes
- * and associates the given driving and walking times with the edge.
+ * Each block of edges is split into one list of arcs per range of source nodes (in parallel,
+ * one task per block). Each range then counts the degrees of its nodes and, after a parallel
+ * prefix sum of the degrees, places its arcs by walking its lists block by block: every node
+ * is written by one task only, and its arcs keep the input order.
  *
- * @param from The starting node of the edge.
- * @param to The ending node of the edge.
- * @param drivingTime The time taken to drive from 'from' to 'to'.
- * @param walkingTime The time taken to walk from 'from' to 'to'.
+ * @note Time Complexity: O(V + E) work, O((V + E) / t) time with t workers.
+ */
+static void buildParallel(const vector<vector<Edge>>& blocks, int n, WorkStealingPool& pool,
+                          vector<int>& offsets, vector<int>& targets, vector<EdgeData>& weights) {
+    struct Arc {
+        int from, to;
+        EdgeData data;
+    };
+
+    // Intervalos de nós: cada um é tratado por uma só tarefa
+    size_t ranges = (size_t)pool.size() * 4;
+    int rangeSize = max(1, (int)((n + ranges - 1) / ranges));
+    ranges = (n + rangeSize - 1) / rangeSize;
+
+    // Partição dos arcos de cada bloco pelo intervalo do nó de origem
+    vector<vector<vector<Arc>>> parts(blocks.size(), vector<vector<Arc>>(ranges));
+    parallelFor(pool, blocks.size(), 1, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b) {
+            for (const auto& e : blocks[b]) {
+                EdgeData data = { e.drivingTime, e.walkingTime };
+                parts[b][e.from / rangeSize].push_back({e.from, e.to, data});
+                parts[b][e.to / rangeSize].push_back({e.to, e.from, data});
+            }
+        }
+    });
+
+    // Graus por intervalo (sem atomics: cada nó pertence a um só intervalo)
+    offsets.assign(n + 1, 0);
+    parallelFor(pool, ranges, 1, [&](size_t first, size_t last) {
+        for (size_t r = first; r < last; ++r) {
+            for (const auto& part : parts) {
+                for (const Arc& a : part[r]) offsets[a.from + 1]++;
+            }
+        }
+    });
+    parallelPrefixSum(pool, offsets);
+
+    // Cada intervalo coloca os seus arcos, bloco a bloco, pela ordem do ficheiro
+    targets.assign(offsets[n], 0);
+    weights.assign(offsets[n], {0, 0});
+    parallelFor(pool, ranges, 1, [&](size_t first, size_t last) {
+        for (size_t r = first; r < last; ++r) {
+            int low = (int)r * rangeSize, high = min(n, low + rangeSize);
+            vector<int> cursor(offsets.begin() + low, offsets.begin() + high);
+            for (auto& part : parts) {
+                for (const Arc& a : part[r]) {
+                    int slot = cursor[a.from - low]++;
+                    targets[slot] = a.to;
+                    weights[slot] = a.data;
+                }
+                vector<Arc>().swap(part[r]);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Builds the CSR representation of the graph from the edges of a builder.
+ *
+ * The node IDs are the IDs of the symbol table, which the graph keeps. Each edge is stored
+ * in both directions (bidirectional graph), and the arcs of every node keep the order in
+ * which the edges appear in the input.
  *
- * @note Time Complexity: O(1), as adding an edge to the adjacency list is a constant-time operation.
+ * @param symbols The symbol table the edges were interned in.
+ * @param builder The edges produced by `parseDistances`.
+ * @param pool The pool that runs the build, or null.
+ *
+ * @note Time Complexity: O(V + E), using a counting sort of the arcs by their source node.
  */
-void Graph::addEdge(const string& from, const string& to, int drivingTime, int walkingTime) {
-    EdgeData data = { drivingTime, walkingTime };     // Cria o objeto com os tempos
-    adj[from].push_back({to, data});          // Adiciona a aresta do nó 'from' para 'to'
-    adj[to].push_back({from, data});          // Adiciona a aresta inversa (grafo bidirecional)
+void Graph::build(SymbolTable symbols, GraphBuilder& builder, WorkStealingPool* pool) {
+    table = make_shared<const SymbolTable>(std::move(symbols));
+    int n = table->size();
+    vector<int> offsetArray, targetArray;
+    vector<EdgeData> weightArray;
+
+    if (pool) {
+        buildParallel(builder.blocks, n, *pool, offsetArray, targetArray, weightArray);
+    } else {
+        // Conta o grau de cada nó
+        offsetArray.assign(n + 1, 0);
+        for (const auto& block : builder.blocks) {
+            for (const auto& e : block) {
+                offsetArray[e.from + 1]++;
+                offsetArray[e.to + 1]++;
+            }
+        }
+        for (int u = 0; u < n; ++u)
+            offsetArray[u + 1] += offsetArray[u];
+
+        // Distribui os arcos pelas posições de cada nó (grafo bidirecional)
+        targetArray.assign(offsetArray[n], 0);
+        weightArray.assign(offsetArray[n], {0, 0});
+        vector<int> cursor(offsetArray.begin(), offsetArray.end() - 1);
+        for (const auto& block : builder.blocks) {
+            for (const auto& e : block) {
+                EdgeData data = { e.drivingTime, e.walkingTime };
+                targetArray[cursor[e.from]] = e.to;
+                weightArray[cursor[e.from]++] = data;
+                targetArray[cursor[e.to]] = e.from;
+                weightArray[cursor[e.to]++] = data;
+            }
+        }
+    }
+
+    offsets = std::move(offsetArray);
+    targets = std::move(targetArray);
+    weights = std::move(weightArray);
+    builder.blocks = vector<vector<Edge>>();
 }
 
 /**
- * @brief Returns the adjacency list of the graph.
+ * @brief Replaces the graph with CSR arrays built elsewhere.
  *
- * This function provides access to the internal representation of the graph,
- * which is stored as a map of nodes to their respective edges.
+ * @param symbols The symbol table of the nodes.
+ * @param offsetArray The V + 1 arc offsets.
+ * @param targetArray The target of every arc.
+ * @param weightArray The travel times of every arc.
  *
- * @return A constant reference to a map where each key is a node and the value
- *         is a vector of pairs representing the connected nodes and their edge data.
+ * @note Time Complexity: O(1); views are not copied.
+ */
+void Graph::assign(SymbolTable symbols, FlatArray<int> offsetArray, FlatArray<int> targetArray,
+                   FlatArray<EdgeData> weightArray) {
+    table = make_shared<const SymbolTable>(std::move(symbols));
+    offsets = std::move(offsetArray);
+    targets = std::move(targetArray);
+    weights = std::move(weightArray);
+}
+
+/**
+ * @brief Prints the adjacency list of the graph to the console.
  *
- * @note Time Complexity: O(1), as accessing the adjacency list is a constant-time operation.
+ * @note Time Complexity: O(V + E), as each node and its arcs are printed once.
  */
-const map<string, vector<pair<string, EdgeData>>>& Graph::getAdjacencyList() const {
-    return adj;  // Devolve o mapa onde estão guardadas as ligações de cada nó
+void Graph::printGraph() const {
+    for (int u = 0; u < nodeCount(); ++u) {
+        cout << table->code(u) << ":";
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e)
+            cout << " " << table->code(targets[e]) << "(" << weights[e].drivingTime << "," << weights[e].walkingTime << ")";
+        cout << "\n";
+    }
 }
@@ -3,54 +3,250 @@
 
 #include <string>
 #include <vector>
-#include <map>
 #include <utility>
+#include <memory>
+#include "parser.h"
+#include "symbols.h"
+#include "flatarray.h"
 
 using namespace std;
 
 /**
- * @class Graph
- * @brief Represents a directed graph with weighted edges.
+ * @struct EdgeData
+ * @brief Travel times associated with a directed arc of the graph.
  *
- * The Graph class stores nodes and edges, where each edge has a driving time and a walking time.
+ * A time of -1 means the arc cannot be used with that means of transport.
  */
 struct EdgeData {
     int drivingTime;
     int walkingTime;
 };
 
+/**
+ * @class GraphView
+ * @brief Read-only, non-owning view of the CSR arrays of a Graph.
+ *
+ * A view is three pointers and a node count: creating or copying one never allocates, and
+ * it can be passed by value to the routing code. It stays valid while the Graph it was
+ * taken from is alive and not rebuilt.
+ */
+class GraphView {
+private:
+    const int* offsets = nullptr;
+    const int* targets = nullptr;
+    const EdgeData* weights = nullptr;
+    int nodes = 0;
+
+public:
+    GraphView() = default;
+    GraphView(const int* offsets, const int* targets, const EdgeData* weights, int nodes)
+        : offsets(offsets), targets(targets), weights(weights), nodes(nodes) {}
+
+    int nodeCount() const { return nodes; }
+    int edgeCount() const { return nodes == 0 ? 0 : offsets[nodes]; }
+    int firstEdge(int node) const { return offsets[node]; }
+    int lastEdge(int node) const { return offsets[node + 1]; }
+    int target(int edge) const { return targets[edge]; }
+    const EdgeData& edgeData(int edge) const { return weights[edge]; }
+
+    /**
+     * @brief Finds the first arc from `from` to `to`.
+     *
+     * @return The arc index, or -1 if the nodes are not adjacent.
+     *
+     * @note Time Complexity: O(d), where d is the out-degree of `from`.
+     */
+    int findEdge(int from, int to) const {
+        for (int e = offsets[from]; e < offsets[from + 1]; ++e) {
+            if (targets[e] == to) return e;
+        }
+        return -1;
+    }
+};
+
+class Graph;
+class WorkStealingPool;
+
+/**
+ * @class GraphBuilder
+ * @brief Collects the edges of a graph while they are parsed, then hands them to `Graph::build`.
+ *
+ * Edges are stored as node IDs and times only, in blocks that keep the order of the input:
+ * a serial parser appends edges one by one, a parallel parser hands over one block per chunk
+ * of the file.
+ */
+class GraphBuilder {
+private:
+    vector<vector<Edge>> blocks;          // arestas pela ordem do ficheiro
+
+    friend class Graph;
+
+public:
+    /**
+     * @brief Reserves room for a number of edges (e.g. estimated from the file size).
+     */
+    void reserve(size_t edgeCount) {
+        if (blocks.empty()) blocks.emplace_back();
+        blocks.back().reserve(blocks.back().size() + edgeCount);
+    }
+
+    /**
+     * @brief Adds an undirected edge between two interned nodes.
+     *
+     * @note Time Complexity: O(1) amortized.
+     */
+    void addEdge(int from, int to, int drivingTime, int walkingTime) {
+        if (blocks.empty()) blocks.emplace_back();
+        blocks.back().push_back({from, to, drivingTime, walkingTime});
+    }
+
+    /**
+     * @brief Appends a block of edges, which follow every edge added before.
+     *
+     * @note Time Complexity: O(1).
+     */
+    void addBlock(vector<Edge>&& edges) {
+        blocks.push_back(std::move(edges));
+        blocks.emplace_back();   // addEdge continua num bloco novo
+    }
+
+    /**
+     * @brief Returns the number of edges added so far.
+     */
+    size_t edgeCount() const {
+        size_t count = 0;
+        for (const auto& block : blocks) count += block.size();
+        return count;
+    }
+};
+
+/**
+ * @class Graph
+ * @brief Represents a directed graph with weighted edges.
+ *
+ * The graph is stored in compressed sparse row (CSR) form: nodes are dense integer IDs,
+ * the arcs leaving node `u` are the positions `[firstEdge(u), lastEdge(u))` of the
+ * contiguous target and weight arrays. The structure is frozen once `build` returns; only the
+ * travel times can still be changed (`setEdgeData`). Copies of a graph share its symbol table,
+ * which never changes after `build`.
+ */
 class Graph {
 private:
-    map<string, vector<pair<string, EdgeData>>> adj;
+    shared_ptr<const SymbolTable> table = make_shared<const SymbolTable>();   // partilhada pelas cópias do grafo
+    FlatArray<int> offsets;               // offsets[u]..offsets[u+1] são os arcos de u
+    FlatArray<int> targets;               // nó de destino de cada arco
+    FlatArray<EdgeData> weights;          // tempos de cada arco
 
 public:
     /**
-     * @brief Adds an edge to the graph.
+     * @brief Builds the CSR representation from the edges collected by a builder.
+     *
+     * The graph takes ownership of the symbol table the edges were interned in; its node IDs
+     * are the graph's node IDs. Every edge is inserted in both directions, with the same
+     * driving and walking times, and the arcs of every node keep the input order. Any previous
+     * contents of the graph are discarded, and the builder is left empty.
      *
-     * Adds a directed edge from one node to another with specified driving and walking times.
+     * With a pool, the arcs are partitioned by node range in parallel, the degrees are counted
+     * per range, the offsets come from a parallel prefix sum, and every range is placed by its
+     * own task; the result is identical to the serial build.
+     *
+     * @param symbols The symbol table filled by `parseLocations`/`parseDistances`.
+     * @param builder The edges produced by `parseDistances`.
+     * @param pool The pool that runs the build, or null to build on the calling thread.
+     *
+     * @note Time Complexity: O(V + E) work, using a counting sort of the arcs by their source node.
+     */
+    void build(SymbolTable symbols, GraphBuilder& builder, WorkStealingPool* pool = nullptr);
+
+    /**
+     * @brief Replaces the graph with CSR arrays built elsewhere, e.g. views into a mapped snapshot.
+     *
+     * @param symbols The symbol table of the nodes.
+     * @param offsets The V + 1 arc offsets.
+     * @param targets The target node of every arc.
+     * @param weights The travel times of every arc.
+     *
+     * @note Time Complexity: O(1); views are not copied.
+     */
+    void assign(SymbolTable symbols, FlatArray<int> offsets, FlatArray<int> targets, FlatArray<EdgeData> weights);
+
+    /**
+     * @brief Changes the travel times of an arc in place (the structure of the graph is unchanged).
+     *
+     * Arcs viewing a mapped snapshot are first copied into memory owned by the graph, so views
+     * taken before the first change keep the old times.
+     *
+     * @note Time Complexity: O(1), or O(E) for the first change of a graph loaded from a snapshot.
+     */
+    void setEdgeData(int edge, const EdgeData& data) { weights.mutableData()[edge] = data; }
+
+    /**
+     * @brief Returns the CSR arrays (offsets, targets and travel times).
+     */
+    const FlatArray<int>& arcOffsets() const { return offsets; }
+    const FlatArray<int>& arcTargets() const { return targets; }
+    const FlatArray<EdgeData>& arcWeights() const { return weights; }
+
+    /**
+     * @brief Returns the symbol table mapping node IDs to location codes, names and IDs.
+     */
+    const SymbolTable& symbols() const { return *table; }
+
+    /**
+     * @brief Returns a read-only view of the CSR arrays.
      *
-     * @param from The starting node of the edge.
-     * @param to The destination node of the edge.
-     * @param drivingTime The time required to drive from `from` to `to`.
-     * @param walkingTime The time required to walk from `from` to `to`.
+     * @note Time Complexity: O(1), no allocation or copy takes place.
+     */
+    GraphView view() const {
+        if (offsets.empty()) return GraphView();
+        return GraphView(offsets.data(), targets.data(), weights.data(), (int)offsets.size() - 1);
+    }
+
+    /**
+     * @brief Returns the number of nodes in the graph.
+     */
+    int nodeCount() const { return table->size(); }
+
+    /**
+     * @brief Returns the number of directed arcs in the graph (twice the number of edges).
+     */
+    int edgeCount() const { return (int)targets.size(); }
+
+    /**
+     * @brief Returns the index of the first arc leaving `node`.
+     */
+    int firstEdge(int node) const { return offsets[node]; }
+
+    /**
+     * @brief Returns one past the index of the last arc leaving `node`.
+     */
+    int lastEdge(int node) const { return offsets[node + 1]; }
+
+    /**
+     * @brief Returns the node an arc points to.
+     */
+    int target(int edge) const { return targets[edge]; }
+
+    /**
+     * @brief Returns the travel times of an arc.
      */
-    void addEdge(const string& from, const string& to, int drivingTime, int walkingTime);
+    const EdgeData& edgeData(int edge) const { return weights[edge]; }
 
     /**
-     * @brief Retrieves the adjacency list of the graph.
+     * @brief Finds the first arc from `from` to `to`.
      *
-     * Provides a reference to the internal adjacency list structure, representing all nodes and edges.
+     * @return The arc index, or -1 if the nodes are not adjacent.
      *
-     * @return A const reference to the adjacency list map.
+     * @note Time Complexity: O(d), where d is the out-degree of `from`.
      */
-    const map<string, vector<pair<string, EdgeData>>>& getAdjacencyList() const;
+    int findEdge(int from, int to) const { return view().findEdge(from, to); }
 
     /**
      * @brief Prints the graph structure.
      *
      * Outputs the graph's adjacency list to the console for visualization.
      *
-     * @note Time Complexity: O(n), where n is the number of nodes in the graph, as each node and its edges are printed.
+     * @note Time Complexity: O(V + E), as each node and its arcs are printed.
      */
     void printGraph() const;
 };
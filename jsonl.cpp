@@ -0,0 +1,442 @@
+#include "jsonl.h"
+#include "route.h"
+#include "threadpool.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <charconv>
+#include <climits>
+
+using namespace std;
+
+/**
+ * @class JsonScanner
+ * @brief Minimal in-place JSON tokenizer over one line.
+ *
+ * Strings are returned as views into the line (escape sequences are skipped over, not decoded;
+ * the values the batch format uses never need them).
+ */
+class JsonScanner {
+private:
+    string_view text;
+    size_t pos = 0;
+
+public:
+    explicit JsonScanner(string_view text) : text(text) {}
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) pos++;
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return pos >= text.size();
+    }
+
+    char peek() {
+        skipSpace();
+        return pos < text.size() ? text[pos] : '\0';
+    }
+
+    bool consume(char c) {
+        if (peek() != c) return false;
+        pos++;
+        return true;
+    }
+
+    bool readString(string_view& out) {
+        if (!consume('"')) return false;
+        size_t start = pos;
+        while (pos < text.size() && text[pos] != '"') {
+            if (text[pos] == '\\') pos++;   // salta o carácter escapado
+            pos++;
+        }
+        if (pos >= text.size()) return false;
+        out = text.substr(start, pos - start);
+        pos++;
+        return true;
+    }
+
+    bool readInt(int& out) {
+        skipSpace();
+        auto [end, ec] = from_chars(text.data() + pos, text.data() + text.size(), out);
+        if (ec != errc()) return false;
+        pos = end - text.data();
+        return true;
+    }
+
+    bool readLiteral(string_view word) {
+        skipSpace();
+        if (text.substr(pos, word.size()) != word) return false;
+        pos += word.size();
+        return true;
+    }
+
+    /**
+     * @brief Skips any JSON value and returns its raw text.
+     */
+    bool skipValue(string_view& raw) {
+        skipSpace();
+        size_t start = pos;
+        char c = peek();
+        if (c == '"') {
+            string_view s;
+            if (!readString(s)) return false;
+        } else if (c == '{' || c == '[') {
+            int depth = 0;
+            while (pos < text.size()) {
+                char d = text[pos];
+                if (d == '"') {
+                    string_view s;
+                    if (!readString(s)) return false;
+                    continue;
+                }
+                if (d == '{' || d == '[') depth++;
+                else if (d == '}' || d == ']') depth--;
+                pos++;
+                if (depth == 0) break;
+            }
+            if (depth != 0) return false;
+        } else {
+            while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' && text[pos] != ' ') pos++;
+            if (pos == start) return false;
+        }
+        raw = text.substr(start, pos - start);
+        return true;
+    }
+};
+
+/**
+ * @brief Reads a location ID that may be `null` (kept as -1).
+ */
+static bool readOptionalId(JsonScanner& in, int& out) {
+    if (in.readLiteral("null")) {
+        out = -1;
+        return true;
+    }
+    return in.readInt(out);
+}
+
+/**
+ * @brief Parses one JSON Lines request.
+ *
+ * @param line The text of the line.
+ * @param request Receives the request.
+ * @param error Receives a description of the problem if the line is not a valid request.
+ * @return True if the line was parsed.
+ *
+ * @note Time Complexity: O(k), where k is the length of the line.
+ */
+bool parseJsonRequest(string_view line, BatchRequest& request, string& error) {
+    request = BatchRequest();
+    JsonScanner in(line);
+
+    if (!in.consume('{')) {
+        error = "expected an object";
+        return false;
+    }
+    if (in.consume('}')) return true;
+
+    do {
+        string_view key;
+        if (!in.readString(key) || !in.consume(':')) {
+            error = "expected a field name";
+            return false;
+        }
+
+        bool ok = true;
+        if (key == "mode") {
+            string_view value;
+            ok = in.readString(value);
+            request.mode = string(value);
+        } else if (key == "engine") {
+            string_view value;
+            ok = in.readString(value) && parseEngine(string(value), request.engine);
+        } else if (key == "alternative") {
+            string_view value;
+            ok = in.readString(value) && parseAlternativeStrategy(string(value), request.alternative);
+        } else if (key == "source") {
+            ok = readOptionalId(in, request.sourceId);
+        } else if (key == "destination") {
+            ok = readOptionalId(in, request.destId);
+        } else if (key == "includeNode") {
+            ok = readOptionalId(in, request.includeNodeId);
+        } else if (key == "maxWalkTime") {
+            ok = readOptionalId(in, request.maxWalkTime);
+        } else if (key == "k") {
+            ok = in.readInt(request.k);
+        } else if (key == "metric" || key == "matrixFile" || key == "format") {
+            string_view value;
+            ok = in.readString(value);
+            (key == "metric" ? request.metric : key == "format" ? request.matrixFormat : request.matrixFile) = string(value);
+        } else if (key == "sources" || key == "targets") {
+            // "all", "parking" ou [id, id, ...] (guardado como lista separada por vírgulas)
+            string& list = key == "sources" ? request.sources : request.targets;
+            string_view value;
+            if (in.peek() == '"') {
+                ok = in.readString(value);
+                list = string(value);
+            } else {
+                ok = in.consume('[');
+                if (ok && !in.consume(']')) {
+                    do {
+                        int id;
+                        ok = in.readInt(id);
+                        if (ok) list += (list.empty() ? "" : ",") + to_string(id);
+                    } while (ok && in.consume(','));
+                    ok = ok && in.consume(']');
+                }
+            }
+        } else if (key == "avoidNodes") {
+            // [id, id, ...]
+            ok = in.consume('[');
+            if (ok && !in.consume(']')) {
+                do {
+                    int id;
+                    ok = in.readInt(id);
+                    if (ok) request.avoidNodeIds.insert(id);
+                } while (ok && in.consume(','));
+                ok = ok && in.consume(']');
+            }
+        } else if (key == "avoidSegments") {
+            // [[id1, id2], ...], guardados nos dois sentidos como no formato de texto
+            ok = in.consume('[');
+            if (ok && !in.consume(']')) {
+                do {
+                    int a, b;
+                    ok = in.consume('[') && in.readInt(a) && in.consume(',') && in.readInt(b) && in.consume(']');
+                    if (ok) {
+                        request.avoidSegmentIds.insert({a, b});
+                        request.avoidSegmentIds.insert({b, a});
+                    }
+                } while (ok && in.consume(','));
+                ok = ok && in.consume(']');
+            }
+        } else {
+            string_view raw;
+            ok = in.skipValue(raw);
+            if (ok && key == "id") request.id = string(raw);
+        }
+
+        if (!ok) {
+            error = "invalid value for \"" + string(key) + "\"";
+            return false;
+        }
+    } while (in.consume(','));
+
+    if (!in.consume('}') || !in.atEnd()) {
+        error = "expected the end of the object";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a route as a JSON object, or null.
+ *
+ * @note Time Complexity: O(n), where n is the number of nodes in the path.
+ */
+static void writeJsonRoute(const SymbolTable& symbols, const vector<int>& path, int time, ResultWriter& output) {
+    if (path.empty()) {
+        output << "null";
+        return;
+    }
+    output << "{\"path\":[";
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (i > 0) output << ",";
+        output << symbols.locationId(path[i]);
+    }
+    output << "],\"time\":" << time << "}";
+}
+
+/**
+ * @brief Writes a JSON string value (quotes and backslashes escaped).
+ */
+static void writeJsonString(string_view text, ResultWriter& output) {
+    output << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') output << '\\';
+        output << c;
+    }
+    output << '"';
+}
+
+/**
+ * @brief Writes the JSON response of a request as a single line.
+ *
+ * @param g The graph the routes belong to.
+ * @param request The request.
+ * @param result The routes computed for it.
+ * @param output The writer that receives the line.
+ *
+ * @note Time Complexity: O(p), where p is the total length of the routes.
+ */
+void writeJsonResult(const Graph& g, const BatchRequest& request, const BatchResult& result, ResultWriter& output) {
+    const SymbolTable& symbols = g.symbols();
+    const string& mode = request.mode;
+
+    output << "{";
+    if (!request.id.empty()) output << "\"id\":" << request.id << ",";
+    output << "\"mode\":";
+    writeJsonString(mode, output);
+
+    if (mode == "matrix") {
+        // Linhas e colunas como IDs dos locais; tempos por linha (null se inalcançável)
+        auto writeIds = [&](const vector<int>& nodes) {
+            output << "[";
+            for (size_t i = 0; i < nodes.size(); ++i)
+                output << (i > 0 ? "," : "") << symbols.locationId(nodes[i]);
+            output << "]";
+        };
+        output << ",\"metric\":";
+        writeJsonString(request.metric, output);
+        output << ",\"sources\":";
+        writeIds(result.matrixSources);
+        output << ",\"targets\":";
+        writeIds(result.matrixTargets);
+        if (!result.message.empty()) {
+            output << ",\"message\":";
+            writeJsonString(result.message, output);
+        } else if (!request.matrixFile.empty()) {
+            output << ",\"matrixFile\":";
+            writeJsonString(request.matrixFile, output);
+        } else {
+            size_t cols = result.matrixTargets.size();
+            output << ",\"matrix\":[";
+            for (size_t i = 0; i < result.matrixSources.size(); ++i) {
+                output << (i > 0 ? ",[" : "[");
+                for (size_t j = 0; j < cols; ++j) {
+                    int d = result.matrix[i * cols + j];
+                    if (j > 0) output << ",";
+                    if (d == INT_MAX) output << "null";
+                    else output << d;
+                }
+                output << "]";
+            }
+            output << "]";
+        }
+        output << "}\n";
+        return;
+    }
+
+    output << ",\"source\":" << request.sourceId << ",\"destination\":" << request.destId;
+
+    if (mode == "driving") {
+        output << ",\"bestDrivingRoute\":";
+        writeJsonRoute(symbols, result.route, calculateDrivingTime(g, result.route), output);
+        output << ",\"alternativeDrivingRoute\":";
+        writeJsonRoute(symbols, result.alternative, calculateDrivingTime(g, result.alternative), output);
+
+    } else if (mode == "driving-restricted") {
+        output << ",\"restrictedDrivingRoute\":";
+        writeJsonRoute(symbols, result.route, calculateDrivingTime(g, result.route), output);
+
+    } else if (mode == "driving-walking") {
+        if (result.parking == -1) {
+            output << ",\"drivingRoute\":null,\"parkingNode\":null,\"walkingRoute\":null,\"totalTime\":null,\"message\":";
+            writeJsonString(result.message, output);
+        } else {
+            int driveTime = calculateDrivingTime(g, result.route);
+            int walkTime = calculateWalkingTime(g, result.walk);
+            output << ",\"drivingRoute\":";
+            writeJsonRoute(symbols, result.route, driveTime, output);
+            output << ",\"parkingNode\":" << symbols.locationId(result.parking) << ",\"walkingRoute\":";
+            writeJsonRoute(symbols, result.walk, walkTime, output);
+            output << ",\"totalTime\":" << (driveTime + walkTime);
+        }
+
+    } else if (mode == "driving-k-shortest") {
+        output << ",\"rankedDrivingRoutes\":[";
+        for (size_t i = 0; i < result.ranked.size(); ++i) {
+            if (i > 0) output << ",";
+            writeJsonRoute(symbols, result.ranked[i].path, result.ranked[i].time, output);
+        }
+        output << "]";
+
+    } else {
+        output << ",\"error\":\"unknown mode\"";
+    }
+    output << "}\n";
+}
+
+/**
+ * @brief Writes the JSON response of a line that is not a valid request.
+ *
+ * @param line The line number of the request.
+ * @param error The description of the problem.
+ * @param output The writer that receives the line.
+ *
+ * @note Time Complexity: O(k), where k is the length of the description.
+ */
+void writeJsonError(size_t line, string_view error, ResultWriter& output) {
+    output << "{\"line\":" << line << ",\"error\":";
+    writeJsonString(error, output);
+    output << "}\n";
+}
+
+/**
+ * @brief Processes a JSON Lines batch file.
+ *
+ * @param net The network representing the locations and edges.
+ * @param inputPath The path to the .jsonl input file.
+ * @param outputPath The path to the .jsonl output file.
+ * @param threads The number of worker threads; 0 uses one per hardware thread.
+ *
+ * @note Time Complexity: O(r * q / t), where r is the number of requests, q the cost of one request and t the number of threads.
+ */
+void processJsonlFile(const Network& net, const string& inputPath, const string& outputPath, int threads) {
+    const size_t chunkSize = 4096;   // linhas lidas de cada vez
+
+    ifstream input(inputPath);
+    ResultWriter output(outputPath);
+    if (!input.is_open() || !output.good()) {
+        cerr << "Erro ao abrir ficheiros." << endl;
+        return;
+    }
+
+    WorkStealingPool pool(threads);
+    vector<string> lines(chunkSize);
+    vector<size_t> lineNumbers(chunkSize);
+    vector<BatchRequest> requests(chunkSize);
+    vector<string> errors(chunkSize);
+    vector<BatchResult> results(chunkSize);
+    size_t lineNumber = 0;
+
+    while (true) {
+        // Lê um bloco de linhas não vazias
+        size_t count = 0;
+        while (count < chunkSize && getline(input, lines[count])) {
+            lineNumber++;
+            if (lines[count].find_first_not_of(" \t\r") == string::npos) continue;
+            lineNumbers[count++] = lineNumber;
+        }
+        if (count == 0) break;
+
+        // Cada linha é independente: análise em paralelo
+        size_t grain = max<size_t>(1, count / (pool.size() * 8));
+        parallelFor(pool, count, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                errors[i].clear();
+                if (!parseJsonRequest(lines[i], requests[i], errors[i]) && errors[i].empty())
+                    errors[i] = "invalid request";
+            }
+        });
+
+        // Pedidos com erro ficam sem modo: não fazem pesquisas
+        for (size_t i = 0; i < count; ++i) {
+            if (!errors[i].empty()) requests[i] = BatchRequest();
+        }
+        solveBatch(net, pool, requests, count, results);
+
+        // Respostas pela ordem do ficheiro de entrada
+        for (size_t i = 0; i < count; ++i) {
+            if (errors[i].empty()) {
+                writeJsonResult(net.graph, requests[i], results[i], output);
+            } else {
+                writeJsonError(lineNumbers[i], errors[i], output);
+            }
+        }
+        if (count < chunkSize) break;
+    }
+}
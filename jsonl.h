@@ -0,0 +1,76 @@
+#ifndef JSONL_HPP
+#define JSONL_HPP
+
+#include <string>
+#include <string_view>
+#include "writer.h"
+#include "batch.h"
+
+/**
+ * @brief Parses one JSON Lines request.
+ *
+ * The line is a flat JSON object with the same fields as a text batch record:
+ * `{"mode":"driving-restricted","engine":"ch","source":8,"destination":1,"avoidNodes":[4],
+ *   "avoidSegments":[[4,2]],"includeNode":3,"maxWalkTime":15}`; a `driving` request may have
+ * `"alternative"` (the strategy name); a `driving-k-shortest` request
+ * has `"k"`; a `matrix` request has `"metric"`,
+ * `"sources"` and `"targets"` ("all", "parking" or an array of IDs), and optionally
+ * `"matrixFile"` and `"format"`. An optional `"id"` (any JSON value) is echoed in the response;
+ * unknown fields are skipped. The line is scanned in place, field by field, straight into the
+ * request: no document tree is built.
+ *
+ * @param line The text of the line (without the newline).
+ * @param request Receives the request.
+ * @param error Receives a description of the problem if the line is not a valid request.
+ * @return True if the line was parsed.
+ *
+ * @note Time Complexity: O(k), where k is the length of the line.
+ */
+bool parseJsonRequest(std::string_view line, BatchRequest& request, std::string& error);
+
+/**
+ * @brief Writes the JSON response of a request as a single line (newline included).
+ *
+ * Routes are objects `{"path":[location IDs],"time":minutes}`, or `null` when there is none:
+ * `bestDrivingRoute`/`alternativeDrivingRoute` for `driving`, `restrictedDrivingRoute` for
+ * `driving-restricted`, `drivingRoute`/`parkingNode`/`walkingRoute`/`totalTime`/`message`
+ * for `driving-walking`, `rankedDrivingRoutes` (an array, fastest first) for `driving-k-shortest`, and `sources`/`targets`/`matrix` (rows of times, null when unreachable)
+ * or `matrixFile` for `matrix`.
+ *
+ * @param g The graph the routes belong to.
+ * @param request The request.
+ * @param result The routes computed for it.
+ * @param output The writer that receives the line.
+ *
+ * @note Time Complexity: O(p), where p is the total length of the routes.
+ */
+void writeJsonResult(const Graph& g, const BatchRequest& request, const BatchResult& result, ResultWriter& output);
+
+/**
+ * @brief Writes the JSON response of a line that is not a valid request: `{"line":n,"error":"..."}`.
+ *
+ * @param line The line number of the request.
+ * @param error The description of the problem.
+ * @param output The writer that receives the line.
+ *
+ * @note Time Complexity: O(k), where k is the length of the description.
+ */
+void writeJsonError(size_t line, std::string_view error, ResultWriter& output);
+
+/**
+ * @brief Processes a JSON Lines batch file: one request per input line, one response per output line.
+ *
+ * Lines are read in chunks; each chunk is parsed and answered in parallel and its responses are
+ * written in input order. Empty lines are skipped; a line that cannot be parsed gets a
+ * `{"line":n,"error":"..."}` response.
+ *
+ * @param net The network representing the locations and edges.
+ * @param inputPath The path to the .jsonl input file.
+ * @param outputPath The path to the .jsonl output file ("-" writes to stdout).
+ * @param threads The number of worker threads; 0 uses one per hardware thread.
+ *
+ * @note Time Complexity: O(r * q / t), where r is the number of requests, q the cost of one request and t the number of threads.
+ */
+void processJsonlFile(const Network& net, const std::string& inputPath, const std::string& outputPath, int threads = 0);
+
+#endif
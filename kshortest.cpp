@@ -0,0 +1,147 @@
+#include "kshortest.h"
+#include "querycontext.h"
+#include "dijkstra.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <climits>
+#include <iterator>
+
+using namespace std;
+
+/**
+ * @struct Candidate
+ * @brief A route of Yen's algorithm with the driving time from the source to each of its nodes.
+ */
+struct Candidate {
+    vector<int> path;
+    vector<int> prefix;   // prefix[i]: tempo da origem até path[i]
+
+    int time() const { return prefix.back(); }
+
+    // Ordem do resultado: tempo e depois os nós, para um desempate determinista
+    bool operator<(const Candidate& other) const {
+        if (time() != other.time()) return time() < other.time();
+        return path < other.path;
+    }
+};
+
+/**
+ * @brief Runs `body(i)` for i in [0, count), on the pool if there is one.
+ */
+static void forEachIndex(WorkStealingPool* pool, size_t count, const function<void(size_t)>& body) {
+    if (!pool) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+    size_t grain = max<size_t>(1, count / (pool->size() * 8));
+    parallelFor(*pool, count, grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) body(i);
+    });
+}
+
+/**
+ * @brief Completes the first j + 1 nodes of a route with a shortest path from its node j to the destination.
+ *
+ * The search runs on the query context of the calling thread, with the avoided nodes and the
+ * nodes before j blocked.
+ *
+ * @param gv The read-only view of the graph.
+ * @param root The route whose first j + 1 nodes are kept.
+ * @param j The index of the node the search starts from.
+ * @param dest The node ID of the destination.
+ * @param avoidNodes Nodes that cannot be used.
+ * @param banned Segments that cannot be used, in either direction.
+ * @param limit Only completions of less than this time are searched.
+ * @param out Receives the route.
+ * @return False if the destination cannot be reached within the limit.
+ *
+ * @note Time Complexity: O(E + V + D), where D is the largest distance.
+ */
+static bool spurSearch(GraphView gv, const Candidate& root, size_t j, int dest, const set<int>& avoidNodes,
+                       const set<pair<int, int>>& banned, int limit, Candidate& out) {
+    int spur = root.path[j];
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(gv.nodeCount());
+    for (int id : avoidNodes) {
+        if (id >= 0 && id < gv.nodeCount()) ctx.block(id);
+    }
+    for (size_t i = 0; i < j; ++i)
+        ctx.block(root.path[i]);   // a rota não pode voltar à raiz
+
+    dijkstraSearch(gv, ctx, spur, banned, &EdgeData::drivingTime, dest, limit);
+    if (!ctx.isSettled(dest)) return false;
+
+    int rootTime = root.prefix[j];
+    out.path.assign(root.path.begin(), root.path.begin() + j);
+    out.prefix.assign(root.prefix.begin(), root.prefix.begin() + j);
+    for (int node : ctx.path(spur, dest)) {
+        out.path.push_back(node);
+        out.prefix.push_back(rootTime + ctx.distance(node));
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the k shortest loopless driving routes between two nodes (Yen's algorithm).
+ *
+ * @param g The graph.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @param k The maximum number of routes.
+ * @param avoidNodes Nodes that no route may use.
+ * @param avoidSegments Segments that no route may use, in either direction.
+ * @param pool The pool that runs the spur searches, or null.
+ * @return Up to k routes, fastest first.
+ *
+ * @note Time Complexity: O(k * L * (E + V + D) / t), where L is the number of nodes of a route, D the largest distance and t the number of threads.
+ */
+vector<RankedRoute> kShortestPaths(const Graph& g, int s, int t, int k, const set<int>& avoidNodes,
+                                   const set<pair<int, int>>& avoidSegments, WorkStealingPool* pool) {
+    GraphView gv = g.view();
+    int n = gv.nodeCount();
+    if (k <= 0 || s < 0 || t < 0 || s >= n || t >= n || s == t || avoidNodes.count(t)) return {};
+
+    vector<Candidate> accepted(1);
+    if (!spurSearch(gv, Candidate{{s}, {0}}, 0, t, avoidNodes, avoidSegments, INT_MAX, accepted[0])) return {};
+
+    set<Candidate> candidates;   // só os que ainda podem entrar no resultado
+    while ((int)accepted.size() < k) {
+        const Candidate& last = accepted.back();
+        size_t needed = k - accepted.size();
+
+        // Limite: um desvio mais lento do que o candidato na posição `needed` nunca é devolvido
+        int bound = candidates.size() >= needed ? next(candidates.begin(), needed - 1)->time() : INT_MAX;
+
+        size_t spurs = last.path.size() - 1;
+        vector<Candidate> found(spurs);
+        vector<char> ok(spurs, false);
+        forEachIndex(pool, spurs, [&](size_t j) {
+            int rootTime = last.prefix[j];
+            if (bound != INT_MAX && rootTime > bound) return;
+
+            // Proíbe o arco seguinte de todas as rotas já aceites que partilham esta raiz
+            set<pair<int, int>> banned = avoidSegments;
+            for (const Candidate& route : accepted) {
+                if (route.path.size() > j + 1 && equal(route.path.begin(), route.path.begin() + j + 1, last.path.begin()))
+                    banned.insert({last.path[j], route.path[j + 1]});
+            }
+            int limit = bound == INT_MAX ? INT_MAX : bound - rootTime + 1;
+            ok[j] = spurSearch(gv, last, j, t, avoidNodes, banned, limit, found[j]);
+        });
+
+        for (size_t j = 0; j < spurs; ++j) {
+            if (ok[j]) candidates.insert(std::move(found[j]));
+        }
+        while (candidates.size() > needed)
+            candidates.erase(prev(candidates.end()));
+        if (candidates.empty()) break;
+
+        accepted.push_back(*candidates.begin());
+        candidates.erase(candidates.begin());
+    }
+
+    vector<RankedRoute> routes;
+    for (Candidate& route : accepted)
+        routes.push_back({std::move(route.path), route.time()});
+    return routes;
+}
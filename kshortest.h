@@ -0,0 +1,46 @@
+#ifndef KSHORTEST_HPP
+#define KSHORTEST_HPP
+
+#include <set>
+#include <utility>
+#include <vector>
+#include "graph.h"
+
+class WorkStealingPool;
+
+/**
+ * @struct RankedRoute
+ * @brief One of the routes returned by `kShortestPaths`.
+ */
+struct RankedRoute {
+    std::vector<int> path;   // IDs dos nós, da origem ao destino
+    int time;                // tempo de condução
+};
+
+/**
+ * @brief Finds the k shortest loopless driving routes between two nodes (Yen's algorithm).
+ *
+ * The first route is a shortest path. Each following route is the best "spur" deviation from
+ * the route found last: for every node j of that route, a Dijkstra search starts at j with the
+ * nodes before it blocked (so routes stay loopless) and with the arcs leaving j on every route
+ * already found with the same prefix banned. The spur searches of one route are independent
+ * and run in parallel, each on the query context of its thread; they stop at the destination
+ * and are pruned by the time of the candidate that currently ranks k-th, since nothing slower
+ * can be returned. Routes are distinct node sequences, ordered by time and then by nodes.
+ *
+ * @param g The graph.
+ * @param source The node ID of the starting location.
+ * @param dest The node ID of the destination location.
+ * @param k The maximum number of routes.
+ * @param avoidNodes Nodes that no route may use.
+ * @param avoidSegments Segments that no route may use, in either direction.
+ * @param pool The pool that runs the spur searches, or null to run them on the calling thread.
+ * @return Up to k routes, fastest first (fewer when the graph has no more).
+ *
+ * @note Time Complexity: O(k * L * (E + V + D) / t), where L is the number of nodes of a route, D the largest distance and t the number of threads.
+ */
+std::vector<RankedRoute> kShortestPaths(const Graph& g, int source, int dest, int k,
+    const std::set<int>& avoidNodes, const std::set<std::pair<int, int>>& avoidSegments,
+    WorkStealingPool* pool = nullptr);
+
+#endif
@@ -0,0 +1,349 @@
+#include "landmarks.h"
+#include "route.h"
+#include "querycontext.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <random>
+
+using namespace std;
+
+/**
+ * @brief Checks that the table gives valid lower bounds for a graph.
+ *
+ * A row gives admissible and consistent bounds if, for every driving arc (u, v) of time w,
+ * |d(L, u) - d(L, v)| <= w, and both ends are either reachable or unreachable from L.
+ *
+ * @param g The graph.
+ * @return True if the table matches the graph.
+ *
+ * @note Time Complexity: O(k * E), where k is the number of landmarks and E the number of arcs.
+ */
+bool LandmarkTable::isConsistentWith(const Graph& g) const {
+    GraphView gv = g.view();
+    if (nodes != gv.nodeCount() || dist.size() != landmarkNodes.size() * (size_t)nodes) return false;
+
+    for (int i = 0; i < landmarkCount(); ++i) {
+        int l = landmarkNodes[i];
+        if (l < 0 || l >= nodes || distance(i, l) != 0) return false;
+
+        for (int u = 0; u < nodes; ++u) {
+            int du = distance(i, u);
+            for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+                int w = gv.edgeData(e).drivingTime;
+                if (w == -1) continue;
+                int dv = distance(i, gv.target(e));
+                if ((du == INT_MAX) != (dv == INT_MAX)) return false;
+                if (du != INT_MAX && (du > dv ? du - dv : dv - du) > w) return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns whether a node has at least one arc that can be driven.
+ *
+ * @note Time Complexity: O(d), where d is the degree of the node.
+ */
+static bool hasDrivingArc(GraphView gv, int node) {
+    for (int e = gv.firstEdge(node); e < gv.lastEdge(node); ++e) {
+        if (gv.edgeData(e).drivingTime != -1) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Picks the next landmark with the "avoid" heuristic.
+ *
+ * Builds the shortest-path tree of a random root and weights every node by how much the current
+ * landmarks underestimate its distance to the root. The subtree weights are summed bottom-up
+ * (subtrees that already contain a landmark weigh 0), and the landmark is the leaf reached by
+ * always descending into the heaviest child.
+ *
+ * @return The chosen node, or -1 if the tree has no positive weight left.
+ *
+ * @note Time Complexity: O((E + V) * log V + k * V).
+ */
+static int pickAvoidLandmark(const Graph& g, const LandmarkTable& current, const vector<char>& isLandmark, int root) {
+    int n = g.nodeCount();
+    vector<int> dist, parent;
+    drivingTree(g, root, dist, parent);
+
+    // Lista de filhos de cada nó da árvore
+    vector<vector<int>> children(n);
+    for (int v = 0; v < n; ++v) {
+        if (parent[v] != -1) children[parent[v]].push_back(v);
+    }
+
+    // Ordem da raiz para as folhas; percorrida ao contrário, os filhos vêm antes dos pais
+    vector<int> order = {root};
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (int c : children[order[i]]) order.push_back(c);
+    }
+
+    vector<long long> size(n, 0);
+    vector<char> covered(n, 0);
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        int v = *it;
+        if (isLandmark[v]) covered[v] = 1;
+        size[v] += dist[v] - current.lowerBound(v, root);
+        if (covered[v]) size[v] = 0;   // subárvore que já contém um landmark
+        if (parent[v] != -1) {
+            size[parent[v]] += size[v];
+            if (covered[v]) covered[parent[v]] = 1;
+        }
+    }
+
+    int at = root;
+    while (true) {
+        int next = -1;
+        for (int c : children[at]) {
+            if (size[c] > 0 && (next == -1 || size[c] > size[next])) next = c;
+        }
+        if (next == -1) break;
+        at = next;
+    }
+    return (at == root && size[root] == 0) || isLandmark[at] ? -1 : at;
+}
+
+/**
+ * @brief Selects landmarks and computes their distance rows.
+ *
+ * Selection is deterministic (fixed random seed), so the same graph always yields the same table.
+ *
+ * @param g The graph.
+ * @param count The number of landmarks.
+ * @param strategy The selection heuristic.
+ * @return The landmark table.
+ *
+ * @note Time Complexity: O(k * (E + V) * log V), where k is the number of landmarks.
+ */
+LandmarkTable buildLandmarks(const Graph& g, int count, LandmarkStrategy strategy) {
+    GraphView gv = g.view();
+    int n = gv.nodeCount();
+
+    // Apenas nós com arcos de condução são candidatos
+    vector<int> candidates;
+    for (int v = 0; v < n; ++v) {
+        if (hasDrivingArc(gv, v)) candidates.push_back(v);
+    }
+    count = min(count, (int)candidates.size());
+
+    mt19937 rng(12345);
+    vector<int> chosen, rows;
+    vector<char> isLandmark(n, 0);
+    vector<int> minDist(n, INT_MAX);   // distância ao landmark mais próximo (estratégia farthest)
+    vector<int> row, parent;
+
+    while ((int)chosen.size() < count) {
+        int next = -1;
+        int root = candidates[rng() % candidates.size()];
+
+        if (strategy == LandmarkStrategy::Avoid && !chosen.empty()) {
+            LandmarkTable current(n, chosen, rows);
+            next = pickAvoidLandmark(g, current, isLandmark, root);
+        }
+        if (next == -1 && chosen.empty()) {
+            // Primeiro landmark: o nó mais afastado de uma raiz aleatória
+            drivingTree(g, root, row, parent);
+            next = root;
+            for (int v : candidates) {
+                if (row[v] != INT_MAX && row[v] > row[next]) next = v;
+            }
+        }
+        if (next == -1) {
+            // Farthest: maximiza a distância ao landmark mais próximo (inalcançável conta como infinito)
+            for (int v : candidates) {
+                if (isLandmark[v]) continue;
+                if (next == -1 || minDist[v] > minDist[next]) next = v;
+            }
+        }
+
+        drivingTree(g, next, row, parent);
+        chosen.push_back(next);
+        isLandmark[next] = 1;
+        rows.insert(rows.end(), row.begin(), row.end());
+        for (int v = 0; v < n; ++v)
+            minDist[v] = min(minDist[v], row[v]);
+    }
+
+    return LandmarkTable(n, chosen, rows);
+}
+
+/**
+ * @brief Writes a landmark table as CSV.
+ *
+ * @param table The landmark table.
+ * @param g The graph the table was built for.
+ * @param filename The path to the CSV file.
+ * @return True if the file was written.
+ *
+ * @note Time Complexity: O(k * V).
+ */
+bool saveLandmarks(const LandmarkTable& table, const Graph& g, const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+
+    const SymbolTable& symbols = g.symbols();
+    file << "Location";
+    for (int l : table.landmarks())
+        file << "," << symbols.code(l);
+    file << "\n";
+
+    for (int v = 0; v < table.nodeCount(); ++v) {
+        file << symbols.code(v);
+        for (int i = 0; i < table.landmarkCount(); ++i) {
+            int d = table.distance(i, v);
+            if (d == INT_MAX) file << ",X";   // ➤ "X" indica que o landmark é inalcançável
+            else file << "," << d;
+        }
+        file << "\n";
+    }
+    return (bool)file;
+}
+
+/**
+ * @brief Reads a landmark table written by `saveLandmarks`.
+ *
+ * @param g The graph the table must match.
+ * @param filename The path to the CSV file.
+ * @param table Receives the table on success.
+ * @return True if the table was read and is consistent with `g`.
+ *
+ * @note Time Complexity: O(k * (V + E)).
+ */
+bool loadLandmarks(const Graph& g, const string& filename, LandmarkTable& table) {
+    ifstream file(filename);
+    if (!file.is_open()) return false;
+
+    const SymbolTable& symbols = g.symbols();
+    int n = g.nodeCount();
+    string line, field;
+
+    // Cabeçalho: códigos dos landmarks
+    if (!getline(file, line)) return false;
+    line.erase(remove(line.begin(), line.end(), '\r'), line.end());
+    stringstream header(line);
+    getline(header, field, ',');
+    vector<int> landmarks;
+    while (getline(header, field, ',')) {
+        int node = symbols.find(field);
+        if (node == -1) return false;
+        landmarks.push_back(node);
+    }
+    int k = (int)landmarks.size();
+
+    vector<int> dist((size_t)k * n, INT_MAX);
+    vector<char> seen(n, 0);
+    int rowsRead = 0;
+    while (getline(file, line)) {
+        line.erase(remove(line.begin(), line.end(), '\r'), line.end());
+        if (line.empty()) continue;
+
+        stringstream ss(line);
+        getline(ss, field, ',');
+        int v = symbols.find(field);
+        if (v == -1 || seen[v]) return false;
+        seen[v] = 1;
+        rowsRead++;
+
+        for (int i = 0; i < k; ++i) {
+            if (!getline(ss, field, ',')) return false;
+            try {
+                dist[(size_t)i * n + v] = (field == "X") ? INT_MAX : stoi(field);
+            } catch (const exception&) {
+                return false;
+            }
+        }
+    }
+    if (rowsRead != n) return false;
+
+    LandmarkTable loaded(n, landmarks, dist);
+    if (!loaded.isConsistentWith(g)) return false;   // ficheiro desatualizado face ao grafo
+    table = std::move(loaded);
+    return true;
+}
+
+/**
+ * @brief Loads the landmark table from a file, rebuilding and rewriting it if needed.
+ *
+ * @param g The graph.
+ * @param filename The path to the CSV file.
+ * @param count The number of landmarks to select when rebuilding.
+ * @return The landmark table.
+ *
+ * @note Time Complexity: O(k * (V + E)) when the file is valid; O(k * (E + V) * log V) when it is rebuilt.
+ */
+LandmarkTable loadOrBuildLandmarks(const Graph& g, const string& filename, int count) {
+    LandmarkTable table;
+    if (loadLandmarks(g, filename, table)) return table;
+
+    table = buildLandmarks(g, count, LandmarkStrategy::Avoid);
+    if (!saveLandmarks(table, g, filename))
+        cerr << "Não foi possível escrever " << filename << endl;
+    return table;
+}
+
+/**
+ * @brief Computes a shortest driving path with A* guided by landmark bounds (ALT).
+ *
+ * The landmark bounds are consistent, so every node is settled at most once with its exact
+ * distance and the search can stop as soon as the destination is settled.
+ *
+ * @param g The graph representing the locations and edges.
+ * @param table The landmark table of `g`.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @param avoidNodes A set of nodes to avoid in the route.
+ * @param avoidSegments A set of segments to avoid in the route.
+ * @return A vector of node IDs representing the route, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: O((E + V) * (log V + k)) in the worst case, where k is the number of landmarks.
+ */
+vector<int> altShortestPath(const Graph& g, const LandmarkTable& table, int s, int t,
+                            const set<int>& avoidNodes,
+                            const set<pair<int, int>>& avoidSegments) {
+    if (s < 0 || t < 0) return {};
+
+    GraphView gv = g.view();
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(gv.nodeCount());
+
+    for (int id : avoidNodes) {
+        if (id >= 0 && id < gv.nodeCount()) ctx.block(id);
+    }
+
+    // A chave de cada nó é a distância + o limite inferior até ao destino
+    auto& pq = ctx.heap();
+    ctx.update(s, 0, -1);
+    pq.push_back({table.lowerBound(s, t), s});
+
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), greater<>());
+        int u = pq.back().second;
+        pq.pop_back();
+        if (ctx.isSettled(u)) continue;
+        ctx.settle(u);
+        if (u == t) break;
+
+        int du = ctx.distance(u);
+        for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+            int v = gv.target(e);
+            const EdgeData& edge = gv.edgeData(e);
+            if (edge.drivingTime == -1) continue;
+            if (ctx.isBlocked(v)) continue;
+            if (!avoidSegments.empty() && (avoidSegments.count({u, v}) || avoidSegments.count({v, u}))) continue;
+
+            int dv = du + edge.drivingTime;
+            if (ctx.distance(v) > dv) {
+                ctx.update(v, dv, u);
+                pq.push_back({dv + table.lowerBound(v, t), v});
+                push_heap(pq.begin(), pq.end(), greater<>());
+            }
+        }
+    }
+
+    return ctx.path(s, t);
+}
@@ -0,0 +1,156 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+#include <utility>
+#include <climits>
+#include "graph.h"
+#include "flatarray.h"
+
+/**
+ * @enum LandmarkStrategy
+ * @brief Heuristics used to choose the landmark nodes.
+ */
+enum class LandmarkStrategy {
+    Farthest,   ///< Each new landmark is the node farthest from the landmarks already chosen.
+    Avoid       ///< "Avoid" heuristic: grows landmarks where the current bounds are weakest.
+};
+
+/**
+ * @class LandmarkTable
+ * @brief Driving-time distances between a few landmark nodes and every node of the graph.
+ *
+ * Driving times are symmetric (every edge is stored in both directions with the same time),
+ * so the distance from a landmark to a node equals the distance from that node to the
+ * landmark, and one row per landmark serves both directions of the triangle inequality.
+ */
+class LandmarkTable {
+private:
+    int nodes = 0;
+    FlatArray<int> landmarkNodes;
+    FlatArray<int> dist;   // dist[i * nodes + v] = distância do landmark i a v (INT_MAX se inalcançável)
+
+public:
+    LandmarkTable() = default;
+
+    /**
+     * @brief Creates a table from precomputed rows.
+     *
+     * @param nodeCount The number of nodes of the graph.
+     * @param landmarks The node IDs of the landmarks.
+     * @param distances The rows of distances, landmark by landmark (`landmarks.size() * nodeCount` values).
+     */
+    LandmarkTable(int nodeCount, FlatArray<int> landmarks, FlatArray<int> distances)
+        : nodes(nodeCount), landmarkNodes(std::move(landmarks)), dist(std::move(distances)) {}
+
+    int nodeCount() const { return nodes; }
+    int landmarkCount() const { return (int)landmarkNodes.size(); }
+    const FlatArray<int>& landmarks() const { return landmarkNodes; }
+    const FlatArray<int>& distances() const { return dist; }
+
+    /**
+     * @brief Returns the driving time between landmark `i` and `node`, or INT_MAX.
+     */
+    int distance(int i, int node) const { return dist[(size_t)i * nodes + node]; }
+
+    /**
+     * @brief Returns a lower bound on the driving time between two nodes.
+     *
+     * Uses |d(L, target) - d(L, node)| <= d(node, target) for every landmark L.
+     *
+     * @note Time Complexity: O(k), where k is the number of landmarks.
+     */
+    int lowerBound(int node, int target) const {
+        int best = 0;
+        for (int i = 0; i < (int)landmarkNodes.size(); ++i) {
+            int a = distance(i, node), b = distance(i, target);
+            if (a == INT_MAX || b == INT_MAX) continue;
+            int bound = a > b ? a - b : b - a;
+            if (bound > best) best = bound;
+        }
+        return best;
+    }
+
+    /**
+     * @brief Checks that the table gives valid lower bounds for a graph.
+     *
+     * The bounds are admissible and consistent as long as every row changes by at most the
+     * driving time of each arc, which holds for exact distances and is checked arc by arc.
+     *
+     * @note Time Complexity: O(k * E).
+     */
+    bool isConsistentWith(const Graph& g) const;
+};
+
+/**
+ * @brief Selects landmarks and computes their distance rows.
+ *
+ * @param g The graph.
+ * @param count The number of landmarks (capped at the number of nodes).
+ * @param strategy The selection heuristic.
+ * @return The landmark table.
+ *
+ * @note Time Complexity: O(k * (E + V) * log V), one or two Dijkstra searches per landmark.
+ */
+LandmarkTable buildLandmarks(const Graph& g, int count, LandmarkStrategy strategy);
+
+/**
+ * @brief Writes a landmark table as CSV.
+ *
+ * The header lists the landmark codes; each following line holds a location code and its
+ * driving time to every landmark, with `X` for unreachable pairs (as in Distances.csv).
+ *
+ * @return True if the file was written.
+ *
+ * @note Time Complexity: O(k * V).
+ */
+bool saveLandmarks(const LandmarkTable& table, const Graph& g, const string& filename);
+
+/**
+ * @brief Reads a landmark table written by `saveLandmarks`.
+ *
+ * The table is rejected if a code is unknown, a node is missing or the distances are not
+ * consistent with the current graph (e.g. Distances.csv changed since it was written).
+ *
+ * @param g The graph the table must match.
+ * @param filename The path to the CSV file.
+ * @param table Receives the table on success.
+ * @return True if the table was read and is valid for `g`.
+ *
+ * @note Time Complexity: O(k * (V + E)).
+ */
+bool loadLandmarks(const Graph& g, const string& filename, LandmarkTable& table);
+
+/**
+ * @brief Loads the landmark table from a file, rebuilding and rewriting it if it is missing or stale.
+ *
+ * @param g The graph.
+ * @param filename The path to the CSV file (e.g. "Landmarks.csv").
+ * @param count The number of landmarks to select when rebuilding.
+ * @return The landmark table.
+ */
+LandmarkTable loadOrBuildLandmarks(const Graph& g, const string& filename, int count);
+
+/**
+ * @brief Computes a shortest driving path with A* guided by landmark bounds (ALT).
+ *
+ * Avoiding nodes or segments only removes arcs, so distances can only grow and the landmark
+ * bounds stay admissible: the result has the same driving time as `dijkstraRestricted`.
+ *
+ * @param g The graph.
+ * @param table The landmark table of `g`.
+ * @param source The starting node.
+ * @param dest The destination node.
+ * @param avoidNodes A set of nodes to avoid (may be empty).
+ * @param avoidSegments A set of edges to avoid (may be empty).
+ * @return A vector of node IDs representing the path, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: O((E + V) * (log V + k)) in the worst case; usually far fewer nodes are settled than with Dijkstra.
+ */
+vector<int> altShortestPath(const Graph& g, const LandmarkTable& table, int source, int dest,
+    const set<int>& avoidNodes,
+    const set<pair<int, int>>& avoidSegments);
+
+#endif
@@ -4,34 +4,17 @@
 #include "route.h"
 #include "graph.h"
 #include "batch.h"
+#include "network.h"
+#include "threadpool.h"
+#include "snapshot.h"
+#include "server.h"
+#include "sharednetwork.h"
+#include "updates.h"
 #include <sstream>
+#include <cstdlib>
 
 using namespace std;
 
-// Vetores globais para guardar locais e segmentos carregados dos ficheiros CSV
-
-/**
- * @brief Stores the locations loaded from the CSV file.
- *
- * Each location represents a node in the graph.
- */
-vector<Location> locations;
-
-/**
- * @brief Stores the edges loaded from the CSV file.
- *
- * Each edge represents a connection between two locations, including
- * driving and walking time.
- */
-vector<Edge> edges;
-
-/**
- * @brief Main graph instance used for route calculations.
- *
- * This graph is built using the loaded locations and edges.
- */
-Graph g;
-
 /**
  * @brief Displays the main menu options for the user.
  *
@@ -59,6 +42,7 @@ void showMainMenu() {
  * Based on the user's input, this function calls the appropriate
  * route calculation function or exits the application.
  *
+ * @param net The loaded network (read-only).
  * @param option The menu option selected by the user.
  *        - 1: Calculate the fastest route.
  *        - 2: Calculate an independent second-fastest route.
@@ -69,7 +53,7 @@ void showMainMenu() {
  *
  * @note Time Complexity: O(n), where n is the number of menu options, as it involves checking the selected option and performing corresponding actions.
  */
-void handleOption(int option) {
+void handleOption(const Network& net, int option) {
     string src, dst;
     switch (option) {
         case 1: {
@@ -77,16 +61,18 @@ void handleOption(int option) {
             cin >> src;
             cout << "ID de destino: ";
             cin >> dst;
-            string code1 = getCodeById(locations, stoi(src));
-            string code2 = getCodeById(locations, stoi(dst));
-            auto path = dijkstraShortestPath(g, code1, code2);
+            const Graph& g = net.graph;
+            const SymbolTable& symbols = g.symbols();
+            int node1 = symbols.fromLocationId(stoi(src));
+            int node2 = symbols.fromLocationId(stoi(dst));
+            auto path = dijkstraShortestPath(g, node1, node2);
             int time = calculateDrivingTime(g, path);
             if (path.empty()) {
                 cout << "Rota impossível.\n";
             } else {
                 cout << "Rota mais rápida: ";
                 for (size_t i = 0; i < path.size(); ++i) {
-                    cout << getIdByCode(locations, path[i]);
+                    cout << symbols.locationId(path[i]);
                     if (i < path.size() - 1) cout << ",";
                 }
                 cout << " (" << time << ")\n";
@@ -95,7 +81,7 @@ void handleOption(int option) {
         }
         // Outras opções seguem o mesmo estilo...
         case 5:
-            processBatchFile(g, "input.txt", "output.txt");
+            processBatchFile(net, "input.txt", "output.txt");
             cout << "Batch processado. Verifica o ficheiro output.txt\n";
             break;
 
@@ -108,30 +94,142 @@ void handleOption(int option) {
     }
 }
 
+/**
+ * @brief Loads the network from the CSV files and computes its preprocessing.
+ *
+ * Reads Locations.csv and Distances.csv (in parallel chunks), builds the CSR graph, then the
+ * ALT landmarks (from Landmarks.csv when it matches), the contraction hierarchy and the CCH.
+ *
+ * @param network Receives the network.
+ * @return False if the CSV files could not be read (the network then has no preprocessing).
+ *
+ * @note Time Complexity: O(n), where n is the number of locations and edges, plus the preprocessing.
+ */
+static bool loadNetworkFromCsv(Network& network) {
+    // Carrega os dados dos ficheiros CSV (só o Network, só de leitura, é partilhado com o resto do programa)
+    vector<Location> locations = parseLocations("Locations.csv");
+    SymbolTable symbols(locations);                       // Cada código é guardado uma única vez
+
+    bool loaded;
+    {
+        WorkStealingPool loader;                          // Threads usadas só durante a leitura
+        GraphBuilder builder;                             // As arestas vão diretamente para o builder
+        loaded = parseDistances("Distances.csv", symbols, builder, &loader) && !locations.empty();
+
+        // Constrói o grafo (formato CSR) com os dados carregados no graph.cpp
+        network.graph.build(std::move(symbols), builder, &loader);
+    }
+    if (!loaded) return false;                            // Sem pré-processamento: não há rede para servir
+
+    // Pré-processamento ALT: lê Landmarks.csv ou recalcula-o se não corresponder ao grafo
+    network.landmarks = make_shared<LandmarkTable>(loadOrBuildLandmarks(network.graph, "Landmarks.csv", 8));
+
+    // Pré-processamento CH sobre os tempos de condução
+    network.ch = make_shared<ContractionHierarchy>(buildContractionHierarchy(network.graph));
+
+    // CCH: topologia (dissecção aninhada) e customização sem restrições
+    network.cch = make_shared<CchTopology>(network.graph);
+    network.cchMetric = make_shared<CchMetric>(customizeCch(*network.cch, network.graph, {}, {}));
+    return true;
+}
+
+/**
+ * @brief Applies a file of travel time updates to a network (see `applyWeightUpdates`).
+ *
+ * @param network The network to update.
+ * @param filename The update file, in the format of Distances.csv.
+ * @return False if the file could not be read.
+ *
+ * @note Time Complexity: O(u * d) plus the recustomized part of the CCH, where u is the number of updates.
+ */
+static bool applyUpdateFile(Network& network, const string& filename) {
+    vector<Edge> updates;
+    if (!parseWeightUpdates(filename, network.graph.symbols(), updates)) {
+        cerr << "Erro ao abrir o ficheiro de atualizações " << filename << "." << endl;
+        return false;
+    }
+    WeightUpdateStats stats = applyWeightUpdates(network, updates);
+    cerr << "Atualizações: " << stats.changedSegments << " segmentos alterados, " << stats.missingSegments
+         << " inexistentes, " << stats.cchArcsChanged << " arcos CCH recustomizados"
+         << (stats.landmarksDropped ? ", ALT descartado" : "") << (stats.chDropped ? ", CH descartada" : "") << "." << endl;
+    return true;
+}
+
 /**
  * @brief Entry point of the program.
  *
  * Loads location and edge data from CSV files, initializes the graph,
  * and enters the main menu loop where the user can choose an option.
  *
+ * Leading options choose where the network comes from: `--snapshot <file>` maps a binary
+ * snapshot instead of reading the CSV files (startup in milliseconds), and
+ * `--save-snapshot <file>` writes the loaded network, preprocessing included, to a snapshot.
+ * `--updates <file>` applies new travel times (Distances.csv format) to the loaded network
+ * without rebuilding it.
+ *
+ * With `--batch <input> <output> [threads]` the batch file is processed once and the program
+ * exits without showing the menu, so many requests can be answered by a single run; an output
+ * of "-" writes the results to stdout (e.g. to pipe them into another program). With
+ * `--serve <socket> [threads]` the program stays loaded and answers JSON Lines requests on a
+ * Unix domain socket (see `runServer`); SIGHUP makes it reload the network from the same source
+ * (snapshot or CSV files) and SIGUSR1 re-reads the `--updates` file and applies it to the
+ * current network, both without interrupting the requests in progress.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments.
  * @return int Returns 0 upon successful execution.
  *
  * @note Time Complexity: O(n), where n is the number of locations and edges, as it involves parsing the CSV files and building the graph.
  */
-int main() {
-    // Carrega os dados dos ficheiros CSV
-    locations = parseLocations("Locations.csv");
-    edges = parseDistances("Distances.csv");
-
-    // Constrói o grafo com os dados carregados no graph.cpp
-    for (const auto& e : edges) {
-        g.addEdge(e.from, e.to, e.drivingTime, e.walkingTime);
+int main(int argc, char* argv[]) {
+    // Opções iniciais: origem da rede e gravação do snapshot
+    string snapshotIn, snapshotOut, updateFile;
+    int arg = 1;
+    while (arg + 1 < argc) {
+        string option = argv[arg];
+        if (option == "--snapshot") snapshotIn = argv[arg + 1];
+        else if (option == "--save-snapshot") snapshotOut = argv[arg + 1];
+        else if (option == "--updates") updateFile = argv[arg + 1];
+        else break;
+        arg += 2;
+    }
+
+    // Grafo e pré-processamentos usados pelos motores de rotas (a mesma origem serve as recargas)
+    auto loadNetwork = [snapshotIn, updateFile](Network& net) {
+        bool loaded = snapshotIn.empty() ? loadNetworkFromCsv(net) : loadSnapshot(snapshotIn, net);
+        if (loaded && !updateFile.empty()) applyUpdateFile(net, updateFile);
+        return loaded;
+    };
+    auto loadedNetwork = make_shared<Network>();
+    if (!loadNetwork(*loadedNetwork) && !snapshotIn.empty()) return 1;
+    const Network& network = *loadedNetwork;
+    if (!snapshotOut.empty() && !saveSnapshot(network, snapshotOut))
+        cerr << "Erro ao escrever o snapshot " << snapshotOut << "." << endl;
+
+    // Modo servidor: responde a pedidos JSON Lines num socket Unix até receber SIGINT/SIGTERM (SIGHUP recarrega)
+    if (argc - arg >= 2 && string(argv[arg]) == "--serve") {
+        int threads = (argc - arg >= 3) ? atoi(argv[arg + 2]) : 0;
+        function<bool(Network&)> update;
+        if (!updateFile.empty()) update = [updateFile](Network& net) { return applyUpdateFile(net, updateFile); };
+        SharedNetwork shared(loadedNetwork, loadNetwork, update);
+        return runServer(shared, argv[arg + 1], threads);
+    }
+
+    // Modo batch pela linha de comandos: sem menu
+    if (argc - arg >= 3 && string(argv[arg]) == "--batch") {
+        int threads = (argc - arg >= 4) ? atoi(argv[arg + 3]) : 0;   // 0: uma thread por núcleo
+        processBatchFile(network, argv[arg + 1], argv[arg + 2], threads);
+        return 0;
     }
 
     // Mostra dados iniciais (nº de locations e de segmentos)
+    const SymbolTable& symbols = network.graph.symbols();
+    int locationCount = 0;
+    for (int v = 0; v < symbols.size(); ++v)
+        locationCount += (symbols.locationId(v) >= 0);
     cout << "=== Dados Analisados: ===\n";
-    cout << "Locais: " << locations.size() << endl;
-    cout << "Segmentos: " << edges.size() << endl;
+    cout << "Locais: " << locationCount << endl;
+    cout << "Segmentos: " << network.graph.edgeCount() / 2 << endl;
 
     // Loop principal do menu
     int option = 0;
@@ -144,9 +242,9 @@ int main() {
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             cout << "Entrada inválida. Insira um número.\n";
         } else {
-            handleOption(option);
+            handleOption(network, option);
         }
     }
 
     return 0;
-}
\ No newline at end of file
+}
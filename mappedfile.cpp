@@ -0,0 +1,68 @@
+#include "mappedfile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Maps a whole file read-only.
+ *
+ * @param path The path of the file.
+ * @param sequential True if the file will be read once from start to end.
+ *
+ * @note Time Complexity: O(1); pages are read from disk on first access.
+ */
+MappedFile::MappedFile(const string& path, bool sequential) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        length = (size_t)info.st_size;
+        if (length == 0) {
+            opened = true;   // mmap não aceita tamanho 0; a vista fica vazia
+        } else {
+            void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                if (sequential) madvise(mapping, length, MADV_SEQUENTIAL);   // leitura do início ao fim
+                bytes = static_cast<const char*>(mapping);
+                opened = true;
+            } else {
+                length = 0;
+            }
+        }
+    }
+    close(fd);   // o mapeamento continua válido sem o descritor
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : bytes(other.bytes), length(other.length), opened(other.opened) {
+    other.bytes = nullptr;
+    other.length = 0;
+    other.opened = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        bytes = other.bytes;
+        length = other.length;
+        opened = other.opened;
+        other.bytes = nullptr;
+        other.length = 0;
+        other.opened = false;
+    }
+    return *this;
+}
+
+/**
+ * @brief Releases the mapping, if there is one.
+ */
+void MappedFile::unmap() {
+    if (bytes) munmap(const_cast<char*>(bytes), length);
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+}
@@ -0,0 +1,63 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The contents are exposed as a `string_view` into the mapping: parsers can scan and slice
+ * the file in place, without copying it into lines or strings. The view is valid while the
+ * MappedFile is alive. Empty files are valid and have an empty view.
+ */
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+    bool opened = false;
+
+    void unmap();
+
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Maps a file.
+     *
+     * @param path The path of the file; `good()` is false if it cannot be opened or mapped.
+     * @param sequential True if the file will be read once from start to end (more read-ahead).
+     */
+    explicit MappedFile(const string& path, bool sequential = false);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Returns whether the file was opened and mapped.
+     */
+    bool good() const { return opened; }
+
+    /**
+     * @brief Returns the contents of the file.
+     */
+    string_view data() const { return string_view(bytes, length); }
+
+    /**
+     * @brief Returns the size of the file in bytes.
+     */
+    size_t size() const { return length; }
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include "matrix.h"
+#include "querycontext.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Runs `body(i)` for i in [0, count), on the pool if there is one.
+ */
+static void forEachIndex(WorkStealingPool* pool, size_t count, const function<void(size_t)>& body) {
+    if (!pool) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+    size_t grain = max<size_t>(1, count / (pool->size() * 8));
+    parallelFor(*pool, count, grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) body(i);
+    });
+}
+
+/**
+ * @brief Settles the whole upward search space of a node.
+ *
+ * @param ch The hierarchy.
+ * @param start The node.
+ * @param space Receives the settled (node, distance) pairs.
+ *
+ * @note Time Complexity: O(U log U), where U is the size of the search space.
+ */
+static void upwardSearchSpace(const ContractionHierarchy& ch, int start, vector<pair<int, int>>& space) {
+    space.clear();
+    if (start < 0 || start >= ch.nodeCount()) return;
+
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(ch.nodeCount());
+    auto& pq = ctx.heap();
+    ctx.update(start, 0, -1);
+    pq.push_back({0, start});
+
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), greater<>());
+        auto [d, u] = pq.back();
+        pq.pop_back();
+        if (ctx.isSettled(u)) continue;
+        ctx.settle(u);
+        space.push_back({u, d});
+
+        for (int i = ch.firstArc(u); i < ch.lastArc(u); ++i) {
+            const ChArc& a = ch.arc(i);
+            if (ctx.distance(a.to) > d + a.weight) {
+                ctx.update(a.to, d + a.weight, u);
+                pq.push_back({d + a.weight, a.to});
+                push_heap(pq.begin(), pq.end(), greater<>());
+            }
+        }
+    }
+}
+
+/**
+ * @brief Settles the upward search space of a node in a customizable hierarchy.
+ *
+ * Every upward arc leads to an ancestor in the elimination tree, so the search just walks up
+ * the tree from the node, relaxing the upward arcs of every reached ancestor.
+ *
+ * @param topology The hierarchy topology.
+ * @param metric The customized metric.
+ * @param start The node.
+ * @param space Receives the reached (node, distance) pairs.
+ *
+ * @note Time Complexity: O(H * d), where H is the elimination tree height and d the upward degree.
+ */
+static void cchUpwardSearchSpace(const CchTopology& topology, const CchMetric& metric, int start,
+                                 vector<pair<int, int>>& space) {
+    space.clear();
+    if (start < 0 || start >= topology.nodeCount()) return;
+
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(topology.nodeCount());
+    ctx.update(start, 0, -1);
+    for (int v = start; v != -1; v = topology.parentOf(v)) {
+        int dv = ctx.distance(v);
+        if (dv == INT_MAX) continue;
+        space.push_back({v, dv});
+        for (int a = topology.firstUpArc(v); a < topology.lastUpArc(v); ++a) {
+            int w = metric.weight[a];
+            int u = topology.upTarget(a);
+            if (w != INT_MAX && ctx.distance(u) > dv + w) ctx.update(u, dv + w, v);
+        }
+    }
+}
+
+/**
+ * @brief Computes times between every source and every target from the upward search spaces of a hierarchy.
+ *
+ * @param n The number of nodes.
+ * @param sources The source nodes (rows).
+ * @param targets The target nodes (columns).
+ * @param pool The pool that runs the searches, or null.
+ * @param search Fills the upward search space of a node; called concurrently from several threads.
+ * @return The times in row-major order (INT_MAX when unreachable).
+ *
+ * @note Time Complexity: O((S + T) * U + S * B), plus the cost of the searches.
+ */
+static vector<int> bucketManyToMany(int n, const vector<int>& sources, const vector<int>& targets,
+                                    WorkStealingPool* pool,
+                                    const function<void(int, vector<pair<int, int>>&)>& search) {
+    size_t rows = sources.size(), cols = targets.size();
+    vector<int> times(rows * cols, INT_MAX);
+
+    // Espaços de procura ascendentes dos destinos (tempos simétricos: a mesma hierarquia serve)
+    vector<vector<pair<int, int>>> spaces(cols);
+    forEachIndex(pool, cols, [&](size_t j) { search(targets[j], spaces[j]); });
+
+    // Baldes em CSR: para cada nó, os destinos que o alcançam e a distância
+    vector<int> bucketOffsets(n + 1, 0);
+    for (const auto& space : spaces) {
+        for (auto [v, d] : space) bucketOffsets[v + 1]++;
+    }
+    for (int v = 0; v < n; ++v)
+        bucketOffsets[v + 1] += bucketOffsets[v];
+    vector<pair<int, int>> buckets(bucketOffsets[n]);   // (coluna, distância)
+    vector<int> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for (size_t j = 0; j < cols; ++j) {
+        for (auto [v, d] : spaces[j]) buckets[cursor[v]++] = {(int)j, d};
+    }
+    spaces.clear();
+    spaces.shrink_to_fit();
+
+    // Cada origem percorre os baldes dos nós que fixa; cada linha é escrita por uma só tarefa
+    forEachIndex(pool, rows, [&](size_t i) {
+        static thread_local vector<pair<int, int>> space;
+        search(sources[i], space);
+        int* row = times.data() + i * cols;
+        for (auto [v, ds] : space) {
+            for (int k = bucketOffsets[v]; k < bucketOffsets[v + 1]; ++k) {
+                auto [j, dt] = buckets[k];
+                row[j] = min(row[j], ds + dt);
+            }
+        }
+    });
+    return times;
+}
+
+/**
+ * @brief Computes driving times between every source and every target with a contraction hierarchy.
+ *
+ * @param ch The hierarchy.
+ * @param sources The source nodes (rows).
+ * @param targets The target nodes (columns).
+ * @param pool The pool that runs the searches, or null.
+ * @return The times in row-major order (INT_MAX when unreachable).
+ *
+ * @note Time Complexity: O((S + T) * U log U + S * B).
+ */
+vector<int> chManyToMany(const ContractionHierarchy& ch, const vector<int>& sources,
+                         const vector<int>& targets, WorkStealingPool* pool) {
+    return bucketManyToMany(ch.nodeCount(), sources, targets, pool,
+        [&](int node, vector<pair<int, int>>& space) { upwardSearchSpace(ch, node, space); });
+}
+
+/**
+ * @brief Computes driving times between every source and every target with a customizable hierarchy.
+ *
+ * @param topology The hierarchy topology.
+ * @param metric The customized metric.
+ * @param sources The source nodes (rows).
+ * @param targets The target nodes (columns).
+ * @param pool The pool that runs the searches, or null.
+ * @return The times in row-major order (INT_MAX when unreachable).
+ *
+ * @note Time Complexity: O((S + T) * H * d + S * B).
+ */
+vector<int> cchManyToMany(const CchTopology& topology, const CchMetric& metric, const vector<int>& sources,
+                          const vector<int>& targets, WorkStealingPool* pool) {
+    return bucketManyToMany(topology.nodeCount(), sources, targets, pool,
+        [&](int node, vector<pair<int, int>>& space) { cchUpwardSearchSpace(topology, metric, node, space); });
+}
+
+/**
+ * @brief Computes the travel times between every source and every target.
+ *
+ * @param net The network.
+ * @param sources The source nodes (rows).
+ * @param targets The target nodes (columns).
+ * @param mode The travel time.
+ * @param pool The pool that runs the searches, or null.
+ * @return The times in row-major order (INT_MAX when unreachable).
+ *
+ * @note Time Complexity: O(S * (E + V + D) / t) without a hierarchy.
+ */
+vector<int> travelTimeMatrix(const Network& net, const vector<int>& sources,
+                             const vector<int>& targets, TravelMode mode, WorkStealingPool* pool) {
+    if (mode == TravelMode::Driving && net.ch)
+        return chManyToMany(*net.ch, sources, targets, pool);
+    // Sem CH (descartada por atualizações de tempos) a CCH recustomizada serve de hierarquia
+    if (mode == TravelMode::Driving && net.cch && net.cchMetric)
+        return cchManyToMany(*net.cch, *net.cchMetric, sources, targets, pool);
+
+    // Sem hierarquia: uma pesquisa de um-para-todos por linha
+    size_t cols = targets.size();
+    vector<int> times(sources.size() * cols, INT_MAX);
+    forEachIndex(pool, sources.size(), [&](size_t i) {
+        if (sources[i] < 0) return;
+        QueryContext& ctx = threadQueryContext();
+        oneToMany(net.graph, ctx, sources[i], mode, {}, {});
+        for (size_t j = 0; j < cols; ++j) {
+            if (targets[j] >= 0) times[i * cols + j] = ctx.distance(targets[j]);
+        }
+    });
+    return times;
+}
+
+/**
+ * @brief Writes a matrix as dense CSV.
+ *
+ * @note Time Complexity: O(S * T).
+ */
+void writeMatrixCsv(const SymbolTable& symbols, const vector<int>& sources, const vector<int>& targets,
+                    const vector<int>& times, ResultWriter& output) {
+    size_t cols = targets.size();
+    for (int t : targets)
+        output << "," << symbols.locationId(t);
+    output << "\n";
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        output << symbols.locationId(sources[i]);
+        for (size_t j = 0; j < cols; ++j) {
+            int d = times[i * cols + j];
+            if (d == INT_MAX) output << ",X";   // ➤ "X" indica que não há rota
+            else output << "," << d;
+        }
+        output << "\n";
+    }
+}
+
+/**
+ * @brief Writes a matrix in binary form.
+ *
+ * @note Time Complexity: O(S * T).
+ */
+void writeMatrixBinary(const SymbolTable& symbols, const vector<int>& sources, const vector<int>& targets,
+                       const vector<int>& times, ResultWriter& output) {
+    auto put = [&](int32_t value) { output.write(reinterpret_cast<const char*>(&value), sizeof value); };
+
+    output.write("TTMX", 4);
+    put((int32_t)sources.size());
+    put((int32_t)targets.size());
+    for (int s : sources) put(symbols.locationId(s));
+    for (int t : targets) put(symbols.locationId(t));
+
+    vector<int32_t> row(targets.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (size_t j = 0; j < targets.size(); ++j) {
+            int d = times[i * targets.size() + j];
+            row[j] = (d == INT_MAX) ? -1 : d;
+        }
+        output.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(int32_t));
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+#include <vector>
+#include <string>
+#include "writer.h"
+#include "network.h"
+#include "route.h"
+
+class WorkStealingPool;
+
+/**
+ * @brief Computes driving times between every source and every target with a contraction hierarchy.
+ *
+ * Bucket-based many-to-many search: the upward search space of every target is stored in
+ * buckets at the nodes it reaches, then the upward search of each source scans the buckets of
+ * the nodes it settles. Each pair's time is the best meeting over those nodes.
+ *
+ * @param ch The hierarchy.
+ * @param sources The source nodes (rows).
+ * @param targets The target nodes (columns).
+ * @param pool The pool that runs the searches, or null to run them on the calling thread.
+ * @return The times in row-major order (INT_MAX when unreachable).
+ *
+ * @note Time Complexity: O((S + T) * U log U + S * B), where U is the size of an upward search space and B the bucket entries scanned per source.
+ */
+std::vector<int> chManyToMany(const ContractionHierarchy& ch, const std::vector<int>& sources,
+    const std::vector<int>& targets, WorkStealingPool* pool);
+
+/**
+ * @brief Computes driving times between every source and every target with a customizable hierarchy.
+ *
+ * The same bucket scheme as `chManyToMany`; the upward search space of a node is the set of its
+ * ancestors in the elimination tree, reached through the customized upward arcs.
+ *
+ * @param topology The hierarchy topology.
+ * @param metric The customized metric (without closures).
+ * @param sources The source nodes (rows).
+ * @param targets The target nodes (columns).
+ * @param pool The pool that runs the searches, or null to run them on the calling thread.
+ * @return The times in row-major order (INT_MAX when unreachable).
+ *
+ * @note Time Complexity: O((S + T) * H * d + S * B), where H is the elimination tree height, d the upward degree and B the bucket entries scanned per source.
+ */
+std::vector<int> cchManyToMany(const CchTopology& topology, const CchMetric& metric, const std::vector<int>& sources,
+    const std::vector<int>& targets, WorkStealingPool* pool);
+
+/**
+ * @brief Computes the travel times between every source and every target.
+ *
+ * Driving times use `chManyToMany` when the network has a hierarchy, or `cchManyToMany` when
+ * it only has the customizable one (e.g. after travel time updates dropped the CH); otherwise
+ * (and for walking) every row is a one-to-all Dijkstra search, run in parallel.
+ *
+ * @param net The network.
+ * @param sources The source nodes (rows).
+ * @param targets The target nodes (columns).
+ * @param mode The travel time.
+ * @param pool The pool that runs the searches, or null to run them on the calling thread.
+ * @return The times in row-major order (INT_MAX when unreachable).
+ *
+ * @note Time Complexity: O(S * (E + V + D) / t) without a hierarchy.
+ */
+std::vector<int> travelTimeMatrix(const Network& net, const std::vector<int>& sources,
+    const std::vector<int>& targets, TravelMode mode, WorkStealingPool* pool);
+
+/**
+ * @brief Writes a matrix as dense CSV: a header row of target location IDs, then one row per source ("X" when unreachable).
+ *
+ * @note Time Complexity: O(S * T).
+ */
+void writeMatrixCsv(const SymbolTable& symbols, const std::vector<int>& sources, const std::vector<int>& targets,
+    const std::vector<int>& times, ResultWriter& output);
+
+/**
+ * @brief Writes a matrix in binary form.
+ *
+ * Layout (native 32-bit integers): the magic "TTMX", the number of rows and of columns, the
+ * source location IDs, the target location IDs, then the times row by row (-1 when unreachable).
+ *
+ * @note Time Complexity: O(S * T).
+ */
+void writeMatrixBinary(const SymbolTable& symbols, const std::vector<int>& sources, const std::vector<int>& targets,
+    const std::vector<int>& times, ResultWriter& output);
+
+#endif
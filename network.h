@@ -0,0 +1,29 @@
+#ifndef NETWORK_HPP
+#define NETWORK_HPP
+
+#include <memory>
+#include "graph.h"
+#include "landmarks.h"
+#include "ch.h"
+#include "cch.h"
+#include "mappedfile.h"
+
+/**
+ * @struct Network
+ * @brief The road network together with its optional preprocessing.
+ *
+ * Everything a query needs is read-only once loaded: the graph (with its symbol table) and the
+ * data precomputed for the faster engines. Missing preprocessing is a null pointer, and the
+ * engines that need it fall back to Dijkstra. A network loaded from a snapshot keeps the mapped
+ * file alive, since its arrays point into it.
+ */
+struct Network {
+    std::shared_ptr<const MappedFile> snapshot;       // snapshot mapeado para onde os arrays apontam (ou nulo)
+    Graph graph;
+    std::shared_ptr<const LandmarkTable> landmarks;   // tabela ALT (Landmarks.csv)
+    std::shared_ptr<const ContractionHierarchy> ch;   // hierarquia sobre os tempos de condução
+    std::shared_ptr<const CchTopology> cch;           // hierarquia customizável (só topologia)
+    std::shared_ptr<const CchMetric> cchMetric;       // customização sem restrições
+};
+
+#endif
@@ -1,13 +1,86 @@
 #include "parser.h"
-#include <fstream>
-#include <sstream>
+#include "symbols.h"
+#include "graph.h"
+#include "mappedfile.h"
+#include "csvscan.h"
+#include "threadpool.h"
+#include <string_view>
+#include <charconv>
 #include <iostream>
 #include <algorithm>
 
+/**
+ * @brief Takes the next line of a text, without its line terminator ("\n" or "\r\n").
+ *
+ * @param text The remaining text; the line is removed from its front.
+ * @return The line.
+ *
+ * @note Time Complexity: O(k), where k is the length of the line.
+ */
+static string_view nextLine(string_view& text) {
+    size_t end = text.find('\n');
+    string_view line = text.substr(0, end);
+    text.remove_prefix(end == string_view::npos ? text.size() : end + 1);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return line;
+}
+
+/**
+ * @brief Takes the next comma-separated field of a line.
+ *
+ * @param line The remaining line; the field and its comma are removed from its front.
+ * @return The field.
+ *
+ * @note Time Complexity: O(k), where k is the length of the field.
+ */
+static string_view nextField(string_view& line) {
+    size_t end = line.find(',');
+    string_view field = line.substr(0, end);
+    line.remove_prefix(end == string_view::npos ? line.size() : end + 1);
+    return field;
+}
+
+/**
+ * @brief Removes the spaces around a field.
+ */
+static string_view trimSpaces(string_view field) {
+    while (!field.empty() && field.front() == ' ') field.remove_prefix(1);
+    while (!field.empty() && field.back() == ' ') field.remove_suffix(1);
+    return field;
+}
+
+/**
+ * @brief Converts a field to an integer with `from_chars`.
+ *
+ * @param field The field (surrounding spaces are ignored).
+ * @param value Receives the integer.
+ * @return False if the field is not an integer.
+ */
+static bool parseInt(string_view field, int& value) {
+    field = trimSpaces(field);
+    auto [end, ec] = from_chars(field.data(), field.data() + field.size(), value);
+    return ec == errc() && end == field.data() + field.size() && !field.empty();
+}
+
+/**
+ * @brief Converts a travel time field ("X" when there is no time) to an integer.
+ *
+ * @return False if the field is neither "X" nor an integer.
+ */
+static bool parseTime(string_view field, int& value) {
+    if (trimSpaces(field) == "X") {
+        value = -1;   // ➤ "X" indica que não há tempo
+        return true;
+    }
+    return parseInt(field, value);
+}
+
 /**
  * @brief Parses a CSV file containing location data.
  *
- * This function reads a file containing location data and returns a vector of `Location` objects.
+ * This function maps the file into memory and returns a vector of `Location` objects. The
+ * fields are sliced in place and the IDs converted with `from_chars`; lines whose ID is not
+ * a number are reported and skipped.
  *
  * @param filename The path to the CSV file containing location data.
  * @return A vector of `Location` objects.
@@ -16,73 +89,224 @@
  */
 vector<Location> parseLocations(const string& filename) {
     vector<Location> locations;
-    ifstream file(filename);
-    string line;
+    MappedFile file(filename, true);
+    string_view text = file.data();
 
-    getline(file, line); // ➤ Ignora a linha de cabeçalho
+    nextLine(text); // ➤ Ignora a linha de cabeçalho
 
     //  Lê linha a linha os dados dos locais
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string name, idStr, code, parkingStr;
+    for (size_t lineNumber = 2; !text.empty(); ++lineNumber) {
+        string_view line = nextLine(text);
+        if (line.empty()) continue;
 
         //  Extrai os campos separados por vírgula
-        getline(ss, name, ',');
-        getline(ss, idStr, ',');
-        getline(ss, code, ',');
-        getline(ss, parkingStr, ',');
+        string_view name = nextField(line);
+        string_view idStr = nextField(line);
+        string_view code = nextField(line);
+        string_view parkingStr = trimSpaces(nextField(line));
 
         Location loc;
+        if (!parseInt(idStr, loc.id)) {                 // ➤ Converte o ID para inteiro
+            cerr << filename << ":" << lineNumber << ": ID inválido." << endl;
+            continue;
+        }
         loc.name = name;
-        loc.id = stoi(idStr);                         // ➤ Converte o ID para inteiro
         loc.code = code;
-        parkingStr.erase(remove(parkingStr.begin(), parkingStr.end(), '\r'), parkingStr.end());
-        parkingStr.erase(remove(parkingStr.begin(), parkingStr.end(), ' '), parkingStr.end());
         loc.hasParking = (parkingStr == "1");
 
-        locations.push_back(loc);
+        locations.push_back(std::move(loc));
     }
 
     return locations;
 }
 
+/**
+ * @brief Reads the next line of a distances file.
+ *
+ * @param scanner The scanner positioned at the start of a line.
+ * @param from Receives the code of the first location.
+ * @param to Receives the code of the second location.
+ * @param drivingTime Receives the driving time (-1 for "X").
+ * @param walkingTime Receives the walking time (-1 for "X").
+ * @return 1 for an edge, 0 for an empty line, -1 for a line with missing fields or an invalid time.
+ *
+ * @note Time Complexity: O(k), where k is the length of the line.
+ */
+static int nextDistanceLine(CsvScanner& scanner, string_view& from, string_view& to, int& drivingTime, int& walkingTime) {
+    string_view fields[4];   // origem, destino, condução, a pé
+    int count = 0;
+    bool lineEnd = false;
+    while (!lineEnd) {
+        string_view field;
+        lineEnd = scanner.nextField(field);
+        if (count < 4) fields[count] = field;
+        count++;   // campos a mais são ignorados
+    }
+    if (count == 1 && fields[0].empty()) return 0;   // linha vazia
+
+    if (count < 4 || !parseTime(fields[2], drivingTime) || !parseTime(fields[3], walkingTime)) return -1;
+    from = fields[0];
+    to = fields[1];
+    return 1;
+}
+
+/**
+ * @brief Parses the lines of a distances file on a pool.
+ *
+ * The text is split into byte ranges that start at a line boundary, and every range is parsed
+ * by its own task into a local block of edges. The codes are looked up read-only while
+ * parsing; the few that are not yet in the table are interned afterwards, range by range and
+ * in file order, so the node IDs are the same as with the serial parser.
+ *
+ * @note Time Complexity: O(m / t + u), where u is the number of codes missing from the table.
+ */
+static void parseDistancesParallel(const string& filename, string_view text, SymbolTable& symbols,
+                                   GraphBuilder& builder, WorkStealingPool& pool) {
+    struct Chunk {
+        string_view text;
+        vector<Edge> edges;
+        vector<pair<size_t, string_view>> unknown;   // (2 * aresta + lado, código) por guardar
+        vector<size_t> invalid;                      // linhas inválidas (índice local)
+        size_t lines = 0;
+    };
+
+    // Pedaços de pelo menos 1 MB, alinhados ao início de uma linha
+    size_t count = min<size_t>((size_t)pool.size() * 4, text.size() / (1 << 20) + 1);
+    vector<Chunk> chunks(count);
+    size_t begin = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t end = (i + 1 == count) ? text.size() : text.find('\n', max(begin, (i + 1) * text.size() / count));
+        end = (end == string_view::npos) ? text.size() : min(text.size(), end + 1);
+        chunks[i].text = text.substr(begin, end - begin);
+        begin = end;
+    }
+
+    parallelFor(pool, count, 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            Chunk& chunk = chunks[i];
+            chunk.edges.reserve(chunk.text.size() / 16);
+            CsvScanner scanner(chunk.text);
+            for (; !scanner.done(); ++chunk.lines) {
+                string_view from, to;
+                int drivingTime, walkingTime;
+                int kind = nextDistanceLine(scanner, from, to, drivingTime, walkingTime);
+                if (kind < 0) chunk.invalid.push_back(chunk.lines);
+                if (kind <= 0) continue;
+
+                // A tabela só é lida aqui; os códigos novos ficam para depois
+                int u = symbols.find(from), v = symbols.find(to);
+                if (u < 0) chunk.unknown.push_back({2 * chunk.edges.size(), from});
+                if (v < 0) chunk.unknown.push_back({2 * chunk.edges.size() + 1, to});
+                chunk.edges.push_back({u, v, drivingTime, walkingTime});
+            }
+        }
+    });
+
+    // Códigos novos guardados pela ordem do ficheiro (os mesmos IDs que na leitura em série)
+    size_t lineNumber = 2;
+    for (Chunk& chunk : chunks) {
+        for (auto [slot, code] : chunk.unknown) {
+            Edge& e = chunk.edges[slot / 2];
+            (slot % 2 ? e.to : e.from) = symbols.intern(code);
+        }
+        for (size_t line : chunk.invalid)
+            cerr << filename << ":" << lineNumber + line << ": linha inválida." << endl;
+        lineNumber += chunk.lines;
+        builder.addBlock(std::move(chunk.edges));
+    }
+}
+
 /**
  * @brief Parses a CSV file containing distance data.
  *
- * This function reads a file containing distance data and returns a vector of `Edge` objects.
+ * This function maps the file into memory and adds every edge straight to a graph builder.
+ * The fields are cut in place by a `CsvScanner` (separators found with SIMD compares, no line
+ * or field strings are created), the location codes are interned in the symbol table, and
+ * the times are converted with `from_chars`. Lines with missing fields or an invalid time are
+ * reported and skipped. With a pool, chunks of the file are parsed in parallel.
  *
  * @param filename The path to the CSV file containing distance data.
- * @return A vector of `Edge` objects.
+ * @param symbols The symbol table used to intern the location codes.
+ * @param builder Receives the edges.
+ * @param pool The pool that parses the chunks, or null.
+ * @return False if the file could not be opened.
+ *
+ * @note Time Complexity: O(m), where m is the number of lines (edges) in the file.
+ */
+bool parseDistances(const string& filename, SymbolTable& symbols, GraphBuilder& builder, WorkStealingPool* pool) {
+    MappedFile file(filename, true);
+    if (!file.good()) return false;
+
+    //  Ignora a linha de cabeçalho
+    string_view text = file.data();
+    size_t header = text.find('\n');
+    text.remove_prefix(header == string_view::npos ? text.size() : header + 1);
+
+    if (pool) {
+        parseDistancesParallel(filename, text, symbols, builder, *pool);
+        return true;
+    }
+
+    //  Lê cada linha e envia a aresta para o builder
+    builder.reserve(text.size() / 16);   // estimativa: ~16 bytes por linha
+    CsvScanner scanner(text);
+    for (size_t lineNumber = 2; !scanner.done(); ++lineNumber) {
+        string_view from, to;
+        int drivingTime, walkingTime;
+        int kind = nextDistanceLine(scanner, from, to, drivingTime, walkingTime);
+        if (kind < 0) cerr << filename << ":" << lineNumber << ": linha inválida." << endl;
+        if (kind <= 0) continue;
+
+        // ➤ Cada código é guardado uma única vez (origem antes do destino)
+        int u = symbols.intern(from);
+        int v = symbols.intern(to);
+        builder.addEdge(u, v, drivingTime, walkingTime);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parses a file of travel time updates.
+ *
+ * The lines are read like those of Distances.csv, but the codes are looked up read-only, so
+ * an update can never add a node to the graph.
  *
- * @note Time Complexity: O(m), where m is the number of lines (edges) in the file. Each line is processed sequentially.
+ * @param filename The path to the update file.
+ * @param symbols The symbol table of the graph.
+ * @param updates Receives the updates, in file order.
+ * @return False if the file could not be opened.
+ *
+ * @note Time Complexity: O(m), where m is the number of lines in the file.
  */
-vector<Edge> parseDistances(const string& filename) {
-    vector<Edge> edges;
-    ifstream file(filename);
-    string line;
-
-    getline(file, line); //  Ignora a linha de cabeçalho
-
-    //  Lê cada linha e cria objetos Edge
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string from, to, drivingStr, walkingStr;
-
-        getline(ss, from, ',');
-        getline(ss, to, ',');
-        getline(ss, drivingStr, ',');
-        getline(ss, walkingStr, ',');
-
-        Edge edge;
-        edge.from = from;
-        edge.to = to;
-        edge.drivingTime = (drivingStr == "X") ? -1 : stoi(drivingStr);   // ➤ "X" indica que não há tempo de condução
-        edge.walkingTime = (walkingStr == "X") ? -1 : stoi(walkingStr);   // ➤ "X" indica que não há tempo a pé
-
-        edges.push_back(edge);
+bool parseWeightUpdates(const string& filename, const SymbolTable& symbols, vector<Edge>& updates) {
+    MappedFile file(filename, true);
+    if (!file.good()) return false;
+
+    //  Ignora a linha de cabeçalho
+    string_view text = file.data();
+    size_t header = text.find('\n');
+    text.remove_prefix(header == string_view::npos ? text.size() : header + 1);
+
+    updates.clear();
+    CsvScanner scanner(text);
+    for (size_t lineNumber = 2; !scanner.done(); ++lineNumber) {
+        string_view from, to;
+        int drivingTime, walkingTime;
+        int kind = nextDistanceLine(scanner, from, to, drivingTime, walkingTime);
+        if (kind < 0) cerr << filename << ":" << lineNumber << ": linha inválida." << endl;
+        if (kind <= 0) continue;
+
+        int u = symbols.find(from);
+        int v = symbols.find(to);
+        if (u < 0 || v < 0) {
+            cerr << filename << ":" << lineNumber << ": local desconhecido." << endl;
+            continue;
+        }
+        updates.push_back({u, v, drivingTime, walkingTime});
     }
 
-    return edges;
+    return true;
 }
 
 /**
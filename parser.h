@@ -23,20 +23,24 @@ struct Location {
  * @struct Edge
  * @brief Represents a connection between two locations with travel times.
  *
- * An edge specifies the travel times (driving and walking) between two locations.
- * If driving is not possible, the driving time is set to -1.
+ * An edge specifies the travel times (driving and walking) between two locations,
+ * identified by their interned node IDs. If driving is not possible, the driving time is set to -1.
  */
 struct Edge {
-    string from;
-    string to;
+    int from;          // ID do nó na SymbolTable
+    int to;
     int drivingTime;   // -1 se não for possível conduzir
     int walkingTime;
 };
 
+class SymbolTable;
+class GraphBuilder;
+class WorkStealingPool;
+
 /**
  * @brief Parses locations from a file.
  *
- * Reads a file and extracts location data into a vector.
+ * Maps the file into memory and extracts location data into a vector.
  *
  * @param filename The path to the file containing location data.
  * @return A vector of parsed locations.
@@ -48,14 +52,36 @@ vector<Location> parseLocations(const string& filename);
 /**
  * @brief Parses distances from a file.
  *
- * Reads a file and extracts edge data representing travel times between locations.
+ * Maps the file into memory and feeds the edges, i.e. the travel times between locations,
+ * straight into a graph builder. Location codes are interned in `symbols`, so the edges only
+ * carry node IDs. With a pool, the file is split into chunks aligned to line boundaries that
+ * are parsed in parallel; the node IDs and the edge order are the same as without one.
  *
  * @param filename The path to the file containing distance data.
- * @return A vector of parsed edges.
+ * @param symbols The symbol table used to intern the location codes.
+ * @param builder Receives the parsed edges.
+ * @param pool The pool that parses the chunks, or null to parse on the calling thread.
+ * @return False if the file could not be opened.
  *
  * @note Time Complexity: O(m), where m is the number of edges in the file, as it involves reading and parsing each line.
  */
-vector<Edge> parseDistances(const string& filename);
+bool parseDistances(const string& filename, SymbolTable& symbols, GraphBuilder& builder, WorkStealingPool* pool = nullptr);
+
+/**
+ * @brief Parses a file of travel time updates.
+ *
+ * The file has the format of Distances.csv (a header, then `Location1,Location2,Driving,Walking`
+ * with "X" for a missing time); every line gives the new times of an existing segment. Codes
+ * are only looked up, never interned: lines with unknown codes are reported and skipped.
+ *
+ * @param filename The path to the update file.
+ * @param symbols The symbol table of the graph.
+ * @param updates Receives the updates, in file order, as edges between node IDs.
+ * @return False if the file could not be opened.
+ *
+ * @note Time Complexity: O(m), where m is the number of lines in the file.
+ */
+bool parseWeightUpdates(const string& filename, const SymbolTable& symbols, vector<Edge>& updates);
 
 /**
  * @brief Retrieves a location code by ID.
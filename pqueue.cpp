@@ -0,0 +1,107 @@
+#include "pqueue.h"
+#include <climits>
+
+/**
+ * @brief Empties the queue and restarts the key window at 0.
+ *
+ * @note Time Complexity: O(1) if the queue was drained; O(B) otherwise, where B is the number of buckets.
+ */
+void DialQueue::clear() {
+    if (count > 0) {
+        for (auto& b : buckets) b.clear();
+    }
+    count = 0;
+    current = 0;
+}
+
+/**
+ * @brief Widens the bucket window so that it covers at least `span` consecutive keys.
+ *
+ * Every pending item has a key in [current, current + size), so its key can be recovered from
+ * its bucket index and it is moved to the matching bucket of the larger array.
+ *
+ * @note Time Complexity: O(B + n), where B is the new number of buckets and n the number of pending items.
+ */
+void DialQueue::grow(int span) {
+    int size = buckets.empty() ? 64 : (int)buckets.size();
+    while (size <= span) size *= 2;
+
+    vector<vector<int>> larger(size);
+    for (int b = 0; b <= mask; ++b) {
+        if (buckets[b].empty()) continue;
+        int key = current + ((b - current) & mask);
+        auto& target = larger[key & (size - 1)];
+        target.insert(target.end(), buckets[b].begin(), buckets[b].end());
+    }
+    buckets = std::move(larger);
+    mask = size - 1;
+}
+
+/**
+ * @brief Inserts a node with a key no smaller than the last key popped.
+ *
+ * @note Time Complexity: O(1) amortized.
+ */
+void DialQueue::push(int key, int node) {
+    if (key - current > mask) grow(key - current);
+    buckets[key & mask].push_back(node);
+    count++;
+}
+
+/**
+ * @brief Removes a pair with the smallest key.
+ *
+ * @return The (key, node) pair. The queue must not be empty.
+ *
+ * @note Time Complexity: O(1) plus the number of empty buckets skipped.
+ */
+pair<int, int> DialQueue::pop() {
+    while (buckets[current & mask].empty()) current++;
+    auto& b = buckets[current & mask];
+    int node = b.back();
+    b.pop_back();
+    count--;
+    return {current, node};
+}
+
+/**
+ * @brief Empties the queue and restarts the keys at 0.
+ *
+ * @note Time Complexity: O(1) (33 buckets).
+ */
+void RadixHeap::clear() {
+    for (auto& b : buckets) b.clear();
+    count = 0;
+    last = 0;
+}
+
+/**
+ * @brief Removes a pair with the smallest key.
+ *
+ * When bucket 0 is empty, the smallest key of the first non-empty bucket becomes `last` and
+ * that bucket is redistributed; all of its items land in strictly lower buckets.
+ *
+ * @return The (key, node) pair. The queue must not be empty.
+ *
+ * @note Time Complexity: O(log C) amortized, where C is the largest key.
+ */
+pair<int, int> RadixHeap::pop() {
+    if (buckets[0].empty()) {
+        int i = 1;
+        while (buckets[i].empty()) i++;
+
+        int smallest = INT_MAX;
+        for (const auto& item : buckets[i])
+            smallest = min(smallest, item.first);
+        last = smallest;
+
+        for (const auto& item : buckets[i])
+            buckets[bucketOf(item.first, last)].push_back(item);
+        buckets[i].clear();
+    }
+
+    pair<int, int> top = buckets[0].back();
+    buckets[0].pop_back();
+    count--;
+    return top;
+}
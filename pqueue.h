@@ -0,0 +1,159 @@
+#ifndef PQUEUE_HPP
+#define PQUEUE_HPP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+/*
+ * Filas de prioridade para o motor de Dijkstra (ver dijkstra.h).
+ *
+ * Todas guardam pares (chave, nó) com IDs densos e a mesma interface:
+ *   push(key, node), pop() -> par com a menor chave, empty(), clear().
+ * Não há "decrease-key": um nó pode ser inserido várias vezes e as cópias antigas são
+ * ignoradas por quem as retira (nó já fixado).
+ */
+
+/**
+ * @class BinaryHeap
+ * @brief Binary min-heap over (key, node) pairs.
+ *
+ * @note Time Complexity: O(log n) per push and pop.
+ */
+class BinaryHeap {
+private:
+    vector<pair<int, int>> items;
+
+public:
+    bool empty() const { return items.empty(); }
+    void clear() { items.clear(); }
+
+    void push(int key, int node) {
+        items.push_back({key, node});
+        push_heap(items.begin(), items.end(), greater<>());
+    }
+
+    pair<int, int> pop() {
+        pop_heap(items.begin(), items.end(), greater<>());
+        pair<int, int> top = items.back();
+        items.pop_back();
+        return top;
+    }
+};
+
+/**
+ * @class DaryHeap
+ * @brief D-ary min-heap over (key, node) pairs.
+ *
+ * A wider heap is shallower, so pushes (the common operation in Dijkstra) are cheaper at the
+ * cost of comparing D children per level when popping.
+ *
+ * @tparam D The number of children per node (at least 2).
+ *
+ * @note Time Complexity: O(log_D n) per push, O(D * log_D n) per pop.
+ */
+template <int D = 4>
+class DaryHeap {
+    static_assert(D >= 2, "DaryHeap precisa de pelo menos 2 filhos por nó");
+
+private:
+    vector<pair<int, int>> items;
+
+public:
+    bool empty() const { return items.empty(); }
+    void clear() { items.clear(); }
+
+    void push(int key, int node) {
+        size_t i = items.size();
+        items.push_back({key, node});
+        while (i > 0) {
+            size_t p = (i - 1) / D;
+            if (items[p] <= items[i]) break;
+            swap(items[p], items[i]);
+            i = p;
+        }
+    }
+
+    pair<int, int> pop() {
+        pair<int, int> top = items[0];
+        items[0] = items.back();
+        items.pop_back();
+
+        size_t i = 0, n = items.size();
+        while (true) {
+            size_t first = i * D + 1;
+            if (first >= n) break;
+            size_t best = first;
+            for (size_t c = first + 1; c < first + D && c < n; ++c) {
+                if (items[c] < items[best]) best = c;
+            }
+            if (items[i] <= items[best]) break;
+            swap(items[i], items[best]);
+            i = best;
+        }
+        return top;
+    }
+};
+
+/**
+ * @class DialQueue
+ * @brief Bucket queue (Dial's algorithm) for monotone integer keys.
+ *
+ * Keys are non-negative integers and never smaller than the last key popped, so a circular
+ * array of buckets indexed by key covers every pending key as long as it is wider than the
+ * largest arc weight. The array grows (power of two) when a key falls outside the window.
+ *
+ * @note Time Complexity: O(1) per push; pops are O(1) amortized plus the empty buckets skipped (at most the largest arc weight per distinct key).
+ */
+class DialQueue {
+private:
+    vector<vector<int>> buckets;   // buckets[key & mask]: nós com essa chave
+    int mask = -1;                 // tamanho - 1 (tamanho potência de 2)
+    int current = 0;               // menor chave que pode estar na fila
+    size_t count = 0;
+
+    void grow(int span);
+
+public:
+    bool empty() const { return count == 0; }
+    void clear();
+    void push(int key, int node);
+    pair<int, int> pop();
+};
+
+/**
+ * @class RadixHeap
+ * @brief Radix heap for monotone integer keys.
+ *
+ * Bucket i holds the keys whose highest bit differing from the last popped key is bit i - 1
+ * (bucket 0 holds keys equal to it). Popping from an empty bucket 0 redistributes the smallest
+ * non-empty bucket, and every item moves to a lower bucket at most 32 times.
+ *
+ * @note Time Complexity: O(1) per push, O(log C) amortized per pop, where C is the largest key.
+ */
+class RadixHeap {
+private:
+    vector<pair<int, int>> buckets[33];
+    int last = 0;      // última chave retirada (todas as chaves pendentes são >= last)
+    size_t count = 0;
+
+    static int bucketOf(int key, int last) {
+        return key == last ? 0 : 32 - __builtin_clz((unsigned)(key ^ last));
+    }
+
+public:
+    bool empty() const { return count == 0; }
+    void clear();
+
+    void push(int key, int node) {
+        buckets[bucketOf(key, last)].push_back({key, node});
+        count++;
+    }
+
+    pair<int, int> pop();
+};
+
+#endif
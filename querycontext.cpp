@@ -0,0 +1,67 @@
+#include "querycontext.h"
+#include <algorithm>
+
+/**
+ * @brief Prepares the context for a new query.
+ *
+ * @param nodeCount The number of nodes of the graph the query runs on.
+ *
+ * @note Time Complexity: O(1) amortized; O(V) only when the arrays have to grow.
+ */
+void QueryContext::prepare(int nodeCount) {
+    if (nodeCount > (int)dist.size()) {
+        dist.resize(nodeCount, INT_MAX);
+        parent.resize(nodeCount, -1);
+        reachedStamp.resize(nodeCount, 0);   // 0 nunca é uma geração válida
+        settledStamp.resize(nodeCount, 0);
+        blockedStamp.resize(nodeCount, 0);
+    }
+    reset();
+}
+
+/**
+ * @brief Invalidates every entry written by the previous query.
+ *
+ * @note Time Complexity: O(1); the stamps are only cleared when the generation counter wraps around.
+ */
+void QueryContext::reset() {
+    heapStorage.clear();
+    if (++generation == 0) {
+        // O contador deu a volta: limpa os carimbos para não confundir gerações antigas
+        fill(reachedStamp.begin(), reachedStamp.end(), 0);
+        fill(settledStamp.begin(), settledStamp.end(), 0);
+        fill(blockedStamp.begin(), blockedStamp.end(), 0);
+        generation = 1;
+    }
+}
+
+/**
+ * @brief Rebuilds a path from the parent pointers of the current query.
+ *
+ * @param source The node the search started from.
+ * @param dest The node the path ends at.
+ * @return The node IDs along the path, or an empty vector if `dest` was not reached through an arc.
+ *
+ * @note Time Complexity: O(n), where n is the number of nodes in the path.
+ */
+vector<int> QueryContext::path(int source, int dest) const {
+    if (parentOf(dest) == -1) return {}; // caminho impossível
+
+    vector<int> nodes;
+    for (int at = dest; at != source; at = parent[at])
+        nodes.push_back(at);
+    nodes.push_back(source);
+    reverse(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+/**
+ * @brief Returns a query context of the calling thread.
+ *
+ * @param slot 0 for the forward search; 1 for the backward search of bidirectional engines.
+ * @return A reference to a context owned by the calling thread.
+ */
+QueryContext& threadQueryContext(int slot) {
+    static thread_local QueryContext contexts[2];
+    return contexts[slot];
+}
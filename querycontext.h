@@ -0,0 +1,118 @@
+#ifndef QUERYCONTEXT_HPP
+#define QUERYCONTEXT_HPP
+
+#include <vector>
+#include <utility>
+#include <climits>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class QueryContext
+ * @brief Reusable workspace for shortest-path searches.
+ *
+ * Owns flat distance, parent, settled and blocked arrays sized to the graph, plus the heap
+ * storage of the priority queue. Every entry carries the generation in which it was written,
+ * so starting a new query only increments the generation: entries from older queries read
+ * as "unreached", and a reset costs O(1) instead of O(V).
+ *
+ * A context is not thread-safe; each thread uses its own (see `threadQueryContext`).
+ */
+class QueryContext {
+private:
+    vector<int> dist;
+    vector<int> parent;
+    vector<uint32_t> reachedStamp;   // geração em que dist/parent foram escritos
+    vector<uint32_t> settledStamp;   // geração em que o nó foi fixado
+    vector<uint32_t> blockedStamp;   // geração em que o nó foi proibido
+    vector<pair<int, int>> heapStorage;
+    uint32_t generation = 1;
+
+public:
+    /**
+     * @brief Prepares the context for a new query on a graph with `nodeCount` nodes.
+     *
+     * Grows the arrays if the graph is larger than any graph seen before, then resets.
+     *
+     * @note Time Complexity: O(1) amortized; O(V) only when the arrays grow.
+     */
+    void prepare(int nodeCount);
+
+    /**
+     * @brief Forgets the previous query.
+     *
+     * @note Time Complexity: O(1), except once every 2^32 resets when the stamps are cleared.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the number of nodes the context is sized for.
+     */
+    int capacity() const { return (int)dist.size(); }
+
+    /**
+     * @brief Returns the tentative distance of a node, or INT_MAX if it was not reached.
+     */
+    int distance(int node) const { return reachedStamp[node] == generation ? dist[node] : INT_MAX; }
+
+    /**
+     * @brief Returns the predecessor of a node in the search tree, or -1.
+     */
+    int parentOf(int node) const { return reachedStamp[node] == generation ? parent[node] : -1; }
+
+    /**
+     * @brief Records a new tentative distance and predecessor for a node.
+     */
+    void update(int node, int distance, int parentNode) {
+        dist[node] = distance;
+        parent[node] = parentNode;
+        reachedStamp[node] = generation;
+    }
+
+    /**
+     * @brief Returns whether a node was already settled in the current query.
+     */
+    bool isSettled(int node) const { return settledStamp[node] == generation; }
+
+    /**
+     * @brief Marks a node as settled in the current query.
+     */
+    void settle(int node) { settledStamp[node] = generation; }
+
+    /**
+     * @brief Returns whether a node is forbidden in the current query.
+     */
+    bool isBlocked(int node) const { return blockedStamp[node] == generation; }
+
+    /**
+     * @brief Forbids a node for the rest of the current query.
+     */
+    void block(int node) { blockedStamp[node] = generation; }
+
+    /**
+     * @brief Returns the reusable storage of the priority queue (empty after a reset).
+     */
+    vector<pair<int, int>>& heap() { return heapStorage; }
+
+    /**
+     * @brief Rebuilds the path from `source` to `dest` following the parent pointers.
+     *
+     * @return The node IDs along the path, or an empty vector if `dest` was not reached through an arc.
+     *
+     * @note Time Complexity: O(n), where n is the number of nodes in the path.
+     */
+    vector<int> path(int source, int dest) const;
+};
+
+/**
+ * @brief Returns a query context of the calling thread.
+ *
+ * The contexts live as long as the thread, so consecutive queries on the same thread reuse
+ * their arrays. Callers must call `prepare` before each query.
+ *
+ * @param slot 0 for the forward search; 1 for the backward search of bidirectional engines.
+ */
+QueryContext& threadQueryContext(int slot = 0);
+
+#endif
@@ -1,296 +1,398 @@
 #include "route.h"
+#include "querycontext.h"
+#include "dijkstra.h"
+#include "alternatives.h"
 #include "parser.h"
-#include <queue>
-#include <map>
 #include <set>
 #include <climits>
 #include <algorithm>
-#include <iostream>
 
 using namespace std;
-extern vector<Location> locations; // Acede à lista global de locais
 
 /**
  * @brief Computes the shortest path using Dijkstra's algorithm.
  *
  * @param g The graph representing the locations and edges.
- * @param source The starting location for the path.
- * @param dest The destination location for the path.
- * @return A vector of strings representing the locations in the shortest path, or an empty vector if no path exists.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @return A vector of node IDs representing the locations in the shortest path, or an empty vector if no path exists.
  *
  * @note Time Complexity: O((E + V) * log V), where E is the number of edges and V is the number of vertices. This complexity arises from the priority queue used in Dijkstra's algorithm.
  */
-vector<string> dijkstraShortestPath(Graph& g, const string& source, const string& dest) {
-    auto adj = g.getAdjacencyList();
-    map<string, int> dist;
-    map<string, string> prev;
-    set<string> visited;
-
-    for (const auto& node : adj)
-        dist[node.first] = INT_MAX;
-
-    dist[source] = 0;
-    priority_queue<pair<int, string>, vector<pair<int, string>>, greater<>> pq;
-    pq.push({0, source});
-
-    while (!pq.empty()) {
-        auto [d, u] = pq.top(); pq.pop();
-        if (visited.count(u)) continue;
-        visited.insert(u);
-
-        for (const auto& [v, edge] : adj[u]) {
-            if (edge.drivingTime == -1) continue; // ignora se não há tempo de condução
-            if (dist[v] > dist[u] + edge.drivingTime) {
-                dist[v] = dist[u] + edge.drivingTime;
-                prev[v] = u;
-                pq.push({dist[v], v});
-            }
-        }
-    }
+vector<int> dijkstraShortestPath(const Graph& g, int s, int t) {
+    if (s < 0 || t < 0) return {};
 
-    if (!prev.count(dest)) return {}; // caminho impossível
+    GraphView gv = g.view();   // vista só de leitura, sem cópia do grafo
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(gv.nodeCount());
 
-    vector<string> path;
-    for (string at = dest; at != source; at = prev[at])
-        path.push_back(at);
-    path.push_back(source);
-    reverse(path.begin(), path.end());
-    return path;
+    dijkstraSearch(gv, ctx, s, {});
+    return ctx.path(s, t);
+}
+
+/**
+ * @brief Parses an alternative strategy as written in batch files.
+ *
+ * @param name The strategy name.
+ * @param strategy Receives the strategy if the name is valid.
+ * @return True if the name is a known strategy.
+ *
+ * @note Time Complexity: O(k), where k is the length of the name.
+ */
+bool parseAlternativeStrategy(const string& name, AlternativeStrategy& strategy) {
+    string key = cleanCode(name);
+    key.erase(remove(key.begin(), key.end(), '\r'), key.end());
+
+    if (key == "disjoint") strategy = AlternativeStrategy::Disjoint;
+    else if (key == "penalty") strategy = AlternativeStrategy::Penalty;
+    else if (key == "plateau") strategy = AlternativeStrategy::Plateau;
+    else if (key == "combined") strategy = AlternativeStrategy::Combined;
+    else return false;
+    return true;
 }
 
 /**
  * @brief Finds an alternative route that avoids the main path.
  *
  * @param g The graph representing the locations and edges.
- * @param source The starting location for the path.
- * @param dest The destination location for the path.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
  * @param mainPath The main path to avoid.
- * @return A vector of strings representing the alternative route, or an empty vector if no route exists.
+ * @param strategy How the alternative is built; all but `Disjoint` go to `filteredAlternativeRoute`.
+ * @return A vector of node IDs representing the alternative route, or an empty vector if no route exists.
  *
  * @note Time Complexity: O((E + V) * log V), where E is the number of edges and V is the number of vertices. This is because the algorithm uses a modified Dijkstra's approach.
  */
-vector<string> findAlternativeRoute(Graph& g, const string& source, const string& dest, const vector<string>& mainPath) {
-    auto adj = g.getAdjacencyList();
+vector<int> findAlternativeRoute(const Graph& g, int s, int t, const vector<int>& mainPath, AlternativeStrategy strategy) {
+    if (s < 0 || t < 0 || mainPath.size() < 2) return {};
+    if (strategy != AlternativeStrategy::Disjoint) return filteredAlternativeRoute(g, s, t, mainPath, strategy);
+
+    GraphView gv = g.view();   // vista só de leitura, sem cópia do grafo
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(gv.nodeCount());
 
     // Evita todos os nós intermédios da rota principal
-    set<string> forbiddenNodes(mainPath.begin() + 1, mainPath.end() - 1);
+    for (size_t i = 1; i + 1 < mainPath.size(); ++i)
+        ctx.block(mainPath[i]);
 
     // Evita os segmentos da rota principal (bidirecional)
-    set<pair<string, string>> forbiddenEdges;
-    for (size_t i = 0; i < mainPath.size() - 1; ++i) {
+    set<pair<int, int>> forbiddenEdges;
+    for (size_t i = 0; i < mainPath.size() - 1; ++i)
         forbiddenEdges.insert({mainPath[i], mainPath[i+1]});
-        forbiddenEdges.insert({mainPath[i+1], mainPath[i]});
-    }
-
-    map<string, int> dist;
-    map<string, string> prev;
-    set<string> visited;
 
-    for (const auto& node : adj)
-        dist[node.first] = INT_MAX;
-
-    dist[source] = 0;
-    priority_queue<pair<int, string>, vector<pair<int, string>>, greater<>> pq;
-    pq.push({0, source});
+    dijkstraSearch(gv, ctx, s, forbiddenEdges);
+    return ctx.path(s, t);
+}
 
-    while (!pq.empty()) {
-        auto [d, u] = pq.top(); pq.pop();
-        if (visited.count(u)) continue;
-        visited.insert(u);
+/**
+ * @brief Computes a shortest driving path with a bidirectional Dijkstra search.
+ *
+ * The graph is bidirectional with symmetric times, so the backward search from `t` uses the
+ * same arcs as the forward one. The side with the smaller queue key is expanded; every arc
+ * relaxation that touches a node reached by the other side is a meeting candidate, and the
+ * search stops when the two smallest keys add up to at least the best candidate.
+ *
+ * @param g The graph representing the locations and edges.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
+ * @param avoidNodes A set of nodes to avoid in the route.
+ * @param avoidSegments A set of segments to avoid in the route.
+ * @return A vector of node IDs representing the route, or an empty vector if no route exists.
+ *
+ * @note Time Complexity: O((E + V) * log V) in the worst case, where E is the number of edges and V is the number of vertices.
+ */
+vector<int> bidirectionalDijkstra(const Graph& g, int s, int t,
+                                  const set<int>& avoidNodes,
+                                  const set<pair<int, int>>& avoidSegments) {
+    if (s < 0 || t < 0 || s == t || avoidNodes.count(t)) return {};
+
+    GraphView gv = g.view();
+    QueryContext& fwd = threadQueryContext(0);
+    QueryContext& bwd = threadQueryContext(1);
+    fwd.prepare(gv.nodeCount());
+    bwd.prepare(gv.nodeCount());
+
+    // A origem pode ser percorrida mesmo que esteja na lista (como em dijkstraRestricted)
+    for (int id : avoidNodes) {
+        if (id < 0 || id >= gv.nodeCount() || id == s) continue;
+        fwd.block(id);
+        bwd.block(id);
+    }
 
-        for (const auto& [v, edge] : adj[u]) {
+    auto& fq = fwd.heap();
+    auto& bq = bwd.heap();
+    fwd.update(s, 0, -1);
+    fq.push_back({0, s});
+    bwd.update(t, 0, -1);
+    bq.push_back({0, t});
+
+    int best = INT_MAX, meet = -1;
+    while (!fq.empty() && !bq.empty()) {
+        if ((long long)fq.front().first + bq.front().first >= best) break; // critério de paragem
+
+        // Expande o lado com a menor chave
+        bool forward = fq.front().first <= bq.front().first;
+        QueryContext& ctx = forward ? fwd : bwd;
+        QueryContext& other = forward ? bwd : fwd;
+        auto& pq = ctx.heap();
+
+        pop_heap(pq.begin(), pq.end(), greater<>());
+        int u = pq.back().second;
+        pq.pop_back();
+        if (ctx.isSettled(u)) continue;
+        ctx.settle(u);
+
+        int du = ctx.distance(u);
+        for (int e = gv.firstEdge(u); e < gv.lastEdge(u); ++e) {
+            int v = gv.target(e);
+            const EdgeData& edge = gv.edgeData(e);
             if (edge.drivingTime == -1) continue;
-            if (forbiddenNodes.count(v)) continue;
-            if (forbiddenEdges.count({u, v}) || forbiddenEdges.count({v, u})) continue;
+            if (ctx.isBlocked(v)) continue;
+            if (!avoidSegments.empty() && (avoidSegments.count({u, v}) || avoidSegments.count({v, u}))) continue;
+
+            int dv = du + edge.drivingTime;
+            if (ctx.distance(v) > dv) {
+                ctx.update(v, dv, u);
+                pq.push_back({dv, v});
+                push_heap(pq.begin(), pq.end(), greater<>());
+            }
 
-            if (dist[v] > dist[u] + edge.drivingTime) {
-                dist[v] = dist[u] + edge.drivingTime;
-                prev[v] = u;
-                pq.push({dist[v], v});
+            // Encontro das duas pesquisas
+            int rest = other.distance(v);
+            if (rest != INT_MAX && dv + rest < best) {
+                best = dv + rest;
+                meet = v;
             }
         }
     }
 
-    if (!prev.count(dest)) return {};
+    if (meet == -1) return {};
 
-    vector<string> path;
-    for (string at = dest; at != source; at = prev[at])
+    // Junta as duas metades: s -> meet (árvore da frente) e meet -> t (árvore de trás)
+    vector<int> path;
+    for (int at = meet; at != -1; at = fwd.parentOf(at))
         path.push_back(at);
-    path.push_back(source);
     reverse(path.begin(), path.end());
+    for (int at = bwd.parentOf(meet); at != -1; at = bwd.parentOf(at))
+        path.push_back(at);
     return path;
 }
 
 /**
- * @brief Calculates the total driving time for a given path.
+ * @brief Computes the shortest travel times from one node to every node.
  *
  * @param g The graph representing the locations and edges.
- * @param path A vector of strings representing the path for which driving time is to be calculated.
- * @return The total driving time in minutes, or -1 if any segment of the path is invalid.
+ * @param ctx The workspace that receives the search tree.
+ * @param source The node ID of the root of the search.
+ * @param mode The travel time to minimize.
+ * @param avoidNodes A set of nodes to avoid.
+ * @param avoidSegments A set of segments to avoid.
  *
- * @note Time Complexity: O(n), where n is the number of segments in the path, as each segment is checked once.
+ * @note Time Complexity: O(E + V + D), where E is the number of edges, V is the number of vertices and D the largest distance.
  */
-int calculateDrivingTime(Graph& g, const vector<string>& path) {
-    if (path.size() < 2) return 0;
+void oneToMany(const Graph& g, QueryContext& ctx, int source, TravelMode mode,
+               const set<int>& avoidNodes,
+               const set<pair<int, int>>& avoidSegments) {
+    GraphView gv = g.view();
+    ctx.prepare(gv.nodeCount());
+    if (source < 0 || source >= gv.nodeCount()) return;
+
+    for (int id : avoidNodes) {
+        if (id >= 0 && id < gv.nodeCount()) ctx.block(id);
+    }
 
-    int total = 0;
-    auto adj = g.getAdjacencyList();
+    int EdgeData::*time = mode == TravelMode::Walking ? &EdgeData::walkingTime : &EdgeData::drivingTime;
+    dijkstraSearch(gv, ctx, source, avoidSegments, time);
+}
 
-    for (size_t i = 0; i < path.size() - 1; ++i) {
-        bool found = false;
-        for (const auto& [v, edge] : adj[path[i]]) {
-            if (v == path[i+1]) {
-                if (edge.drivingTime == -1) return -1;
-                total += edge.drivingTime;
-                found = true;
-                break;
-            }
-        }
-        if (!found) return -1;
-    }
+/**
+ * @brief Computes the shortest travel times from every node to one node.
+ *
+ * @param g The graph representing the locations and edges.
+ * @param ctx The workspace that receives the search tree.
+ * @param dest The node ID of the common destination.
+ * @param mode The travel time to minimize.
+ * @param avoidNodes A set of nodes to avoid.
+ * @param avoidSegments A set of segments to avoid.
+ *
+ * @note Time Complexity: O(E + V + D), where E is the number of edges, V is the number of vertices and D the largest distance.
+ */
+void manyToOne(const Graph& g, QueryContext& ctx, int dest, TravelMode mode,
+               const set<int>& avoidNodes,
+               const set<pair<int, int>>& avoidSegments) {
+    // Tempos simétricos: a pesquisa inversa a partir do destino usa os mesmos arcos
+    oneToMany(g, ctx, dest, mode, avoidNodes, avoidSegments);
+}
 
-    return total;
+/**
+ * @brief Computes the driving-time shortest-path tree of a source node.
+ *
+ * @param g The graph representing the locations and edges.
+ * @param source The node ID of the root of the tree.
+ * @param dist Receives the driving time from `source` to every node (INT_MAX if unreachable).
+ * @param parent Receives the predecessor of every node in the tree (-1 for the root and unreachable nodes).
+ *
+ * @note Time Complexity: O((E + V) * log V), where E is the number of edges and V is the number of vertices.
+ */
+void drivingTree(const Graph& g, int source, vector<int>& dist, vector<int>& parent) {
+    GraphView gv = g.view();
+    int n = gv.nodeCount();
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(n);
+
+    dijkstraSearch(gv, ctx, source, {});
+
+    dist.resize(n);
+    parent.resize(n);
+    for (int v = 0; v < n; ++v) {
+        dist[v] = ctx.distance(v);
+        parent[v] = ctx.parentOf(v);
+    }
 }
 
 /**
- * @brief Calculates the total walking time for a given path.
+ * @brief Sums one of the travel times along a path.
  *
  * @param g The graph representing the locations and edges.
- * @param path A vector of strings representing the path for which walking time is to be calculated.
- * @return The total walking time in minutes, or -1 if any segment of the path is invalid.
+ * @param path The node IDs along the path.
+ * @param walking True to sum walking times, false to sum driving times.
+ * @return The total time in minutes, or -1 if any segment of the path is invalid.
  *
- * @note Time Complexity: O(n), where n is the number of segments in the path, as each segment is checked once.
+ * @note Time Complexity: O(n * d), where n is the number of segments in the path and d the maximum node degree.
  */
-int calculateWalkingTime(Graph& g, const vector<string>& path) {
+static int sumPathTime(const Graph& g, const vector<int>& path, bool walking) {
     if (path.size() < 2) return 0;
 
+    GraphView gv = g.view();
     int total = 0;
-    auto adj = g.getAdjacencyList();
-
     for (size_t i = 0; i < path.size() - 1; ++i) {
-        bool found = false;
-        for (const auto& [v, edge] : adj[path[i]]) {
-            if (v == path[i+1]) {
-                if (edge.walkingTime == -1) return -1;
-                total += edge.walkingTime;
-                found = true;
-                break;
-            }
-        }
-        if (!found) return -1;
+        int e = gv.findEdge(path[i], path[i+1]);
+        if (e == -1) return -1;
+
+        int time = walking ? gv.edgeData(e).walkingTime : gv.edgeData(e).drivingTime;
+        if (time == -1) return -1;
+        total += time;
     }
 
     return total;
 }
 
+/**
+ * @brief Calculates the total driving time for a given path.
+ *
+ * @param g The graph representing the locations and edges.
+ * @param path A vector of node IDs representing the path for which driving time is to be calculated.
+ * @return The total driving time in minutes, or -1 if any segment of the path is invalid.
+ *
+ * @note Time Complexity: O(n), where n is the number of segments in the path, as each segment is checked once.
+ */
+int calculateDrivingTime(const Graph& g, const vector<int>& path) {
+    return sumPathTime(g, path, false);
+}
+
+/**
+ * @brief Calculates the total walking time for a given path.
+ *
+ * @param g The graph representing the locations and edges.
+ * @param path A vector of node IDs representing the path for which walking time is to be calculated.
+ * @return The total walking time in minutes, or -1 if any segment of the path is invalid.
+ *
+ * @note Time Complexity: O(n), where n is the number of segments in the path, as each segment is checked once.
+ */
+int calculateWalkingTime(const Graph& g, const vector<int>& path) {
+    return sumPathTime(g, path, true);
+}
+
 /**
  * @brief Computes a restricted route avoiding specified nodes and segments.
  *
  * @param g The graph representing the locations and edges.
- * @param source The starting location for the path.
- * @param dest The destination location for the path.
+ * @param s The node ID of the starting location.
+ * @param t The node ID of the destination location.
  * @param avoidNodes A set of nodes to avoid in the route.
  * @param avoidSegments A set of segments to avoid in the route.
- * @return A vector of strings representing the restricted route, or an empty vector if no route exists.
+ * @return A vector of node IDs representing the restricted route, or an empty vector if no route exists.
  *
  * @note Time Complexity: O((E + V) * log V), where E is the number of edges and V is the number of vertices. This complexity arises due to the priority queue and the node/segment avoidance checks.
  */
-vector<string> dijkstraRestricted(Graph& g, const string& source, const string& dest,
-                                  const set<string>& avoidNodes,
-                                  const set<pair<string, string>>& avoidSegments) {
-    auto adj = g.getAdjacencyList();
-    map<string, int> dist;
-    map<string, string> prev;
-    set<string> visited;
-
-    for (const auto& node : adj)
-        dist[node.first] = INT_MAX;
-
-    dist[source] = 0;
-    priority_queue<pair<int, string>, vector<pair<int, string>>, greater<>> pq;
-    pq.push({0, source});
-
-    while (!pq.empty()) {
-        auto [d, u] = pq.top(); pq.pop();
-        if (visited.count(u)) continue;
-        visited.insert(u);
-
-        for (const auto& [v, edge] : adj[u]) {
-            if (edge.drivingTime == -1) continue;
-            if (avoidNodes.count(v)) continue;
-            if (avoidSegments.count({u, v}) || avoidSegments.count({v, u})) continue;
-
-            if (dist[v] > dist[u] + edge.drivingTime) {
-                dist[v] = dist[u] + edge.drivingTime;
-                prev[v] = u;
-                pq.push({dist[v], v});
-            }
-        }
+vector<int> dijkstraRestricted(const Graph& g, int s, int t,
+                               const set<int>& avoidNodes,
+                               const set<pair<int, int>>& avoidSegments) {
+    if (s < 0 || t < 0) return {};
+
+    GraphView gv = g.view();   // vista só de leitura, sem cópia do grafo
+    QueryContext& ctx = threadQueryContext();
+    ctx.prepare(gv.nodeCount());
+
+    // Marca os nós proibidos no contexto para um teste O(1) por arco
+    for (int id : avoidNodes) {
+        if (id >= 0 && id < gv.nodeCount()) ctx.block(id);
     }
 
-    if (!prev.count(dest)) return {};
-
-    vector<string> path;
-    for (string at = dest; at != source; at = prev[at])
-        path.push_back(at);
-    path.push_back(source);
-    reverse(path.begin(), path.end());
-    return path;
+    dijkstraSearch(gv, ctx, s, avoidSegments);
+    return ctx.path(s, t);
 }
 
 /**
  * @brief Finds an eco-friendly route that minimizes driving and walking time.
  *
  * @param g The graph representing the locations and edges.
- * @param source The starting location for the route.
- * @param dest The destination location for the route.
+ * @param source The node ID of the starting location.
+ * @param dest The node ID of the destination location.
  * @param maxWalkTime The maximum allowable walking time.
  * @param avoidNodes A set of nodes to avoid in the route.
  * @param avoidSegments A set of segments to avoid in the route.
  * @param message A reference to a string for outputting messages about the route findings.
- * @return A tuple containing the driving path, the best parking location, and the walking path.
+ * @return A tuple containing the driving path, the best parking node (-1 if none), and the walking path.
  *
- * @note Time Complexity: O((E + V) * log V + P * (E + V)), where E is the number of edges, V is the number of vertices, and P is the number of parking candidates. The complexity comes from running Dijkstra's algorithm multiple times for each parking candidate.
+ * @note Time Complexity: O(E + V + D), where E is the number of edges, V is the number of vertices and D the largest distance: one driving and one walking search, then a scan of the parking candidates.
  */
-tuple<vector<string>, string, vector<string>> findEcoRoute(
-    Graph& g,
-    const string& source,
-    const string& dest,
+tuple<vector<int>, int, vector<int>> findEcoRoute(
+    const Graph& g,
+    int source,
+    int dest,
     int maxWalkTime,
-    const set<string>& avoidNodes,
-    const set<pair<string, string>>& avoidSegments,
+    const set<int>& avoidNodes,
+    const set<pair<int, int>>& avoidSegments,
     string& message)
 {
-    auto adj = g.getAdjacencyList();
-    vector<string> parkingCandidates;
+    vector<int> parkingCandidates;
 
     // Recolher todos os locais com parque
-    for (const auto& loc : locations) {
-        if (loc.hasParking) {
-            parkingCandidates.push_back(loc.code);
+    const SymbolTable& symbols = g.symbols();
+    for (int node = 0; node < symbols.size(); ++node) {
+        if (symbols.hasParking(node)) {
+            parkingCandidates.push_back(node);
         }
     }
 
     if (parkingCandidates.empty()) {
         message = "No parking nodes available.";
-        return {{}, "", {}};
+        return make_tuple(vector<int>(), -1, vector<int>());
     }
 
-    string bestPark = "";
+    if (source < 0 || dest < 0 || avoidNodes.count(dest)) {
+        message = "No viable eco route found.";
+        return make_tuple(vector<int>(), -1, vector<int>());
+    }
+
+    // Uma pesquisa de condução a partir da origem e uma a pé até ao destino
+    QueryContext& drive = threadQueryContext(0);
+    QueryContext& walk = threadQueryContext(1);
+    oneToMany(g, drive, source, TravelMode::Driving, avoidNodes, avoidSegments);
+    manyToOne(g, walk, dest, TravelMode::Walking, avoidNodes, avoidSegments);
+
+    int bestPark = -1;
     int bestTotal = INT_MAX;
     int bestWalkTime = -1;
-    vector<string> bestDrivePath, bestWalkPath;
 
     for (const auto& park : parkingCandidates) {
         if (avoidNodes.count(park)) continue;
+        if (park == source || park == dest) continue;   // é preciso conduzir e caminhar
 
-        auto drivePath = dijkstraRestricted(g, source, park, avoidNodes, avoidSegments);
-        auto walkPath = dijkstraRestricted(g, park, dest, avoidNodes, avoidSegments);
-
-        if (drivePath.empty() || walkPath.empty()) continue;
-
-        int driveTime = calculateDrivingTime(g, drivePath);
-        int walkTime = calculateWalkingTime(g, walkPath);
+        int driveTime = drive.distance(park);
+        int walkTime = walk.distance(park);
+        if (driveTime == INT_MAX || walkTime == INT_MAX) continue;
 
         if (walkTime > maxWalkTime) continue;
 
@@ -301,16 +403,18 @@ tuple<vector<string>, string, vector<string>> findEcoRoute(
             bestTotal = total;
             bestWalkTime = walkTime;
             bestPark = park;
-            bestDrivePath = drivePath;
-            bestWalkPath = walkPath;
         }
     }
 
-    if (bestDrivePath.empty() || bestWalkPath.empty()) {
+    if (bestPark == -1) {
         message = "No viable eco route found.";
-        return {{}, "", {}};
+        return make_tuple(vector<int>(), -1, vector<int>());
     }
 
+    vector<int> bestDrivePath = drive.path(source, bestPark);
+    vector<int> bestWalkPath = walk.path(dest, bestPark);
+    reverse(bestWalkPath.begin(), bestWalkPath.end());   // a árvore a pé tem raiz no destino
+
     message = "Eco route found.";
     return {bestDrivePath, bestPark, bestWalkPath};
 }
@@ -5,6 +5,39 @@
 #include <tuple>
 #include "graph.h"
 
+class QueryContext;
+
+/**
+ * @enum TravelMode
+ * @brief Which travel time of a segment a search minimizes.
+ */
+enum class TravelMode {
+    Driving,   ///< `EdgeData::drivingTime`
+    Walking    ///< `EdgeData::walkingTime`
+};
+
+/**
+ * @enum AlternativeStrategy
+ * @brief How `findAlternativeRoute` builds the alternative to a shortest route.
+ */
+enum class AlternativeStrategy {
+    Disjoint,   ///< Shortest route that avoids every intermediate node and every segment of the main route.
+    Penalty,    ///< Best filtered candidate of repeated searches with the used segments made slower (`penaltyAlternatives`).
+    Plateau,    ///< Best filtered candidate formed on the plateaus of the forward and backward trees (`plateauAlternatives`).
+    Combined    ///< Best filtered candidate of both methods.
+};
+
+/**
+ * @brief Parses an alternative strategy as written in batch files ("disjoint", "penalty", "plateau" or "combined").
+ *
+ * @param name The strategy name (case-sensitive, surrounding spaces ignored).
+ * @param strategy Receives the strategy if the name is valid.
+ * @return True if the name is a known strategy.
+ *
+ * @note Time Complexity: O(k), where k is the length of the name.
+ */
+bool parseAlternativeStrategy(const std::string& name, AlternativeStrategy& strategy);
+
 /**
  * @brief Computes the shortest path using Dijkstra's algorithm.
  *
@@ -13,26 +46,33 @@
  * @param g The graph in which to find the shortest path.
  * @param source The starting node.
  * @param dest The destination node.
- * @return A vector of node identifiers representing the shortest path.
+ * @return A vector of node IDs representing the shortest path.
  *
  * @note Time Complexity: O((E + V) * log V), where E is the number of edges and V is the number of vertices. This complexity arises from the priority queue used in Dijkstra's algorithm.
  */
-std::vector<std::string> dijkstraShortestPath(Graph& g, const std::string& source, const std::string& dest);
+std::vector<int> dijkstraShortestPath(const Graph& g, int source, int dest);
 
 /**
  * @brief Finds an alternative route to the main shortest path.
  *
  * Attempts to find a different route between the source and destination while avoiding the given main path.
+ * The `Disjoint` strategy shares no intermediate node or segment with it, which often means
+ * a long detour or no route at all. The other strategies look for a route a driver would
+ * actually consider, at a constant number of searches (see alternatives.h): it must be at most
+ * 25% slower, share at most 80% of the main route's time with it, and be locally optimal
+ * (every stretch of it up to a quarter of the main route's time is a shortest path).
  *
  * @param g The graph in which to find the route.
  * @param source The starting node.
  * @param dest The destination node.
  * @param mainPath The primary shortest path to avoid.
- * @return A vector of node identifiers representing the alternative route.
+ * @param strategy How the alternative is built.
+ * @return A vector of node IDs representing the alternative route (empty if there is none).
  *
- * @note Time Complexity: O((E + V) * log V), where E is the number of edges and V is the number of vertices. This is because the algorithm uses a modified Dijkstra's approach.
+ * @note Time Complexity: O((E + V) * log V), where E is the number of edges and V is the number of vertices. This is because the algorithm uses a modified Dijkstra's approach; the other strategies run a constant number of such searches.
  */
-std::vector<std::string> findAlternativeRoute(Graph& g, const std::string& source, const std::string& dest, const std::vector<std::string>& mainPath);
+std::vector<int> findAlternativeRoute(const Graph& g, int source, int dest, const std::vector<int>& mainPath,
+    AlternativeStrategy strategy = AlternativeStrategy::Disjoint);
 
 /**
  * @brief Computes a shortest path with restrictions.
@@ -44,13 +84,87 @@ std::vector<std::string> findAlternativeRoute(Graph& g, const std::string& sourc
  * @param dest The destination node.
  * @param avoidNodes A set of nodes to avoid.
  * @param avoidSegments A set of edges to avoid.
- * @return A vector of node identifiers representing the restricted shortest path.
+ * @return A vector of node IDs representing the restricted shortest path.
  *
  * @note Time Complexity: O((E + V) * log V), where E is the number of edges and V is the number of vertices. This complexity arises due to the priority queue and the node/segment avoidance checks.
  */
-std::vector<std::string> dijkstraRestricted(Graph& g, const std::string& source, const std::string& dest,
-    const std::set<std::string>& avoidNodes,
-    const std::set<std::pair<std::string, std::string>>& avoidSegments);
+std::vector<int> dijkstraRestricted(const Graph& g, int source, int dest,
+    const std::set<int>& avoidNodes,
+    const std::set<std::pair<int, int>>& avoidSegments);
+
+/**
+ * @brief Computes a shortest driving path with a bidirectional Dijkstra search.
+ *
+ * Runs one search forward from the source and one backward from the destination, always
+ * expanding the side with the smaller queue key, and stops as soon as the sum of both keys
+ * reaches the best meeting distance found so far. Gives the same distances as
+ * `dijkstraRestricted` (equal-cost ties may resolve to a different path).
+ *
+ * @param g The graph in which to find the path.
+ * @param source The starting node.
+ * @param dest The destination node.
+ * @param avoidNodes A set of nodes to avoid (may be empty).
+ * @param avoidSegments A set of edges to avoid (may be empty).
+ * @return A vector of node IDs representing the shortest path.
+ *
+ * @note Time Complexity: O((E + V) * log V) in the worst case; in practice each side only explores roughly the ball of half the path length.
+ */
+std::vector<int> bidirectionalDijkstra(const Graph& g, int source, int dest,
+    const std::set<int>& avoidNodes,
+    const std::set<std::pair<int, int>>& avoidSegments);
+
+/**
+ * @brief Computes the shortest travel times from one node to every node (one-to-many).
+ *
+ * Runs a single full Dijkstra search; afterwards `ctx.distance(v)` is the time from `source` to
+ * `v` (INT_MAX if unreachable) and `ctx.path(source, v)` the route. Segments without a time in
+ * the chosen mode are skipped, and the avoided nodes are never entered (the source itself may be
+ * left even if it is in the list, as in `dijkstraRestricted`).
+ *
+ * @param g The graph.
+ * @param ctx The workspace that receives the search tree (it is prepared here).
+ * @param source The root of the search.
+ * @param mode The travel time to minimize.
+ * @param avoidNodes A set of nodes to avoid (may be empty).
+ * @param avoidSegments A set of edges to avoid (may be empty).
+ *
+ * @note Time Complexity: O(E + V + D) with the default bucket queue, where D is the largest distance.
+ */
+void oneToMany(const Graph& g, QueryContext& ctx, int source, TravelMode mode,
+    const std::set<int>& avoidNodes,
+    const std::set<std::pair<int, int>>& avoidSegments);
+
+/**
+ * @brief Computes the shortest travel times from every node to one node (many-to-one).
+ *
+ * Travel times are the same in both directions, so this is the one-to-many search of `dest`:
+ * `ctx.distance(v)` is the time from `v` to `dest`, and the route from `v` is `ctx.path(dest, v)`
+ * reversed.
+ *
+ * @param g The graph.
+ * @param ctx The workspace that receives the search tree (it is prepared here).
+ * @param dest The common destination.
+ * @param mode The travel time to minimize.
+ * @param avoidNodes A set of nodes to avoid (may be empty).
+ * @param avoidSegments A set of edges to avoid (may be empty).
+ *
+ * @note Time Complexity: O(E + V + D) with the default bucket queue, where D is the largest distance.
+ */
+void manyToOne(const Graph& g, QueryContext& ctx, int dest, TravelMode mode,
+    const std::set<int>& avoidNodes,
+    const std::set<std::pair<int, int>>& avoidSegments);
+
+/**
+ * @brief Computes the driving-time shortest-path tree of a source node.
+ *
+ * @param g The graph.
+ * @param source The root of the tree.
+ * @param dist Receives the driving time from `source` to every node (INT_MAX if unreachable).
+ * @param parent Receives the predecessor of every node in the tree (-1 for the root and unreachable nodes).
+ *
+ * @note Time Complexity: O((E + V) * log V).
+ */
+void drivingTree(const Graph& g, int source, std::vector<int>& dist, std::vector<int>& parent);
 
 /**
  * @brief Computes the total driving time for a given path.
@@ -63,7 +177,7 @@ std::vector<std::string> dijkstraRestricted(Graph& g, const std::string& source,
  *
  * @note Time Complexity: O(n), where n is the number of segments in the path, as each segment is checked once.
  */
-int calculateDrivingTime(Graph& g, const std::vector<std::string>& path);
+int calculateDrivingTime(const Graph& g, const std::vector<int>& path);
 
 /**
  * @brief Computes the total walking time for a given path.
@@ -76,7 +190,7 @@ int calculateDrivingTime(Graph& g, const std::vector<std::string>& path);
  *
  * @note Time Complexity: O(n), where n is the number of segments in the path, as each segment is checked once.
  */
-int calculateWalkingTime(Graph& g, const std::vector<std::string>& path);
+int calculateWalkingTime(const Graph& g, const std::vector<int>& path);
 
 /**
  * @brief Computes the total length of a given path.
@@ -87,12 +201,14 @@ int calculateWalkingTime(Graph& g, const std::vector<std::string>& path);
  * @param path The sequence of nodes forming the path.
  * @return The total path length.
  */
-int calculatePathLength(Graph& g, const std::vector<std::string>& path);
+int calculatePathLength(const Graph& g, const std::vector<int>& path);
 
 /**
  * @brief Finds an eco-friendly route balancing walking and driving.
  *
  * Computes a route that minimizes driving while considering a maximum walking time and avoiding specific nodes and segments.
+ * One driving search from the source and one walking search towards the destination cover every
+ * parking candidate, which are then compared in a single scan.
  *
  * @param g The graph in which to find the route.
  * @param source The starting node.
@@ -101,15 +217,15 @@ int calculatePathLength(Graph& g, const std::vector<std::string>& path);
  * @param avoidNodes A set of nodes to avoid.
  * @param avoidSegments A set of edges to avoid.
  * @param message A reference string to store messages about the route calculation.
- * @return A tuple containing the walking path, a message, and the driving path.
+ * @return A tuple containing the driving path, the parking node (-1 if none), and the walking path.
  *
- * @note Time Complexity: O((E + V) * log V + P * (E + V)), where E is the number of edges, V is the number of vertices, and P is the number of parking candidates. The complexity comes from running Dijkstra's algorithm multiple times for each parking candidate.
+ * @note Time Complexity: O(E + V + D), where E is the number of edges, V is the number of vertices and D the largest distance: two searches, independent of the number of parking candidates.
  */
-std::tuple<std::vector<std::string>, std::string, std::vector<std::string>> findEcoRoute(
-    Graph& g,
-    const std::string& source,
-    const std::string& dest,
+std::tuple<std::vector<int>, int, std::vector<int>> findEcoRoute(
+    const Graph& g,
+    int source,
+    int dest,
     int maxWalkTime,
-    const std::set<std::string>& avoidNodes,
-    const std::set<std::pair<std::string, std::string>>& avoidSegments,
+    const std::set<int>& avoidNodes,
+    const std::set<std::pair<int, int>>& avoidSegments,
     std::string& message);
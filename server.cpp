@@ -0,0 +1,387 @@
+#include "server.h"
+#include "sharednetwork.h"
+#include "batch.h"
+#include "jsonl.h"
+#include "writer.h"
+#include "threadpool.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <map>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+
+using namespace std;
+
+static const size_t maxInFlight = 256;             // pedidos por responder de uma ligação
+static const size_t maxLineLength = 1 << 20;       // uma linha maior fecha a ligação
+static const size_t maxPendingOutput = 16 << 20;   // respostas por enviar antes de parar de ler
+
+// Identificadores epoll reservados; as ligações usam 3, 4, ...
+static const uint64_t listenKey = 0, wakeKey = 1, signalKey = 2;
+
+/**
+ * @struct Connection
+ * @brief State of one client connection, owned by the event loop thread.
+ */
+struct Connection {
+    int fd = -1;
+    string input;                     // bytes recebidos; as linhas completas começam em inputStart
+    size_t inputStart = 0;
+    string output;                    // respostas por enviar, a partir de outputSent
+    size_t outputSent = 0;
+    uint64_t nextSubmit = 0;          // sequência do próximo pedido
+    uint64_t nextWrite = 0;           // sequência da próxima resposta a enviar
+    map<uint64_t, string> ready;      // respostas que terminaram antes das anteriores
+    size_t lineNumber = 0;
+    bool peerClosed = false;          // o cliente já não envia mais pedidos
+    bool broken = false;              // erro de socket ou protocolo: fechar já
+    uint32_t events = 0;              // eventos registados no epoll
+
+    size_t inFlight() const { return nextSubmit - nextWrite; }
+    size_t pendingOutput() const { return output.size() - outputSent; }
+};
+
+/**
+ * @struct Completion
+ * @brief A response produced by a worker, on its way back to the event loop.
+ */
+struct Completion {
+    uint64_t connection;
+    uint64_t sequence;
+    string response;
+};
+
+/**
+ * @class CompletionQueue
+ * @brief Hands finished responses from the workers to the event loop, waking it through an eventfd.
+ */
+class CompletionQueue {
+private:
+    mutex lock;
+    vector<Completion> items;
+    int wakeFd;
+
+public:
+    explicit CompletionQueue(int wakeFd) : wakeFd(wakeFd) {}
+
+    void push(Completion&& completion) {
+        {
+            lock_guard<mutex> guard(lock);
+            items.push_back(std::move(completion));
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof one);
+        (void)ignored;   // o contador só pode transbordar com 2^64 - 1 respostas por ler
+    }
+
+    vector<Completion> take() {
+        lock_guard<mutex> guard(lock);
+        vector<Completion> taken;
+        taken.swap(items);
+        return taken;
+    }
+};
+
+/**
+ * @brief Answers one request line into a response line.
+ *
+ * @note Time Complexity: that of the request.
+ */
+static string answerLine(const SharedNetwork& shared, const string& line, size_t lineNumber) {
+    static thread_local ResultWriter writer;   // buffer em memória reutilizado por cada worker
+    writer.clear();
+
+    // A rede fica presa até ao fim do pedido, mesmo que outra seja publicada entretanto
+    shared_ptr<const Network> pinned = shared.acquire();
+    const Network& net = *pinned;
+
+    BatchRequest request;
+    string error;
+    if (!parseJsonRequest(line, request, error)) {
+        writeJsonError(lineNumber, error.empty() ? "invalid request" : error, writer);
+    } else if (!request.matrixFile.empty()) {
+        writeJsonError(lineNumber, "matrixFile is not allowed in server mode", writer);
+    } else {
+        writeJsonResult(net.graph, request, solveBatchRequest(net, request), writer);
+    }
+    return string(writer.text());
+}
+
+/**
+ * @brief Hands the complete lines of a connection to the pool, up to the in-flight limit.
+ *
+ * @note Time Complexity: O(b), where b is the number of buffered bytes.
+ */
+static void submitLines(const SharedNetwork& shared, WorkStealingPool& pool, CompletionQueue& completions,
+                        uint64_t key, Connection& c) {
+    while (c.inFlight() < maxInFlight && !c.broken) {
+        size_t end = c.input.find('\n', c.inputStart);
+        if (end == string::npos) {
+            if (c.input.size() - c.inputStart > maxLineLength) c.broken = true;
+            // Sem mais dados, o que resta é a última linha (sem '\n')
+            if (!c.peerClosed || c.inputStart == c.input.size()) break;
+            end = c.input.size();
+        }
+
+        string line = c.input.substr(c.inputStart, end - c.inputStart);
+        c.inputStart = min(end + 1, c.input.size());
+        c.lineNumber++;
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+
+        uint64_t sequence = c.nextSubmit++;
+        size_t lineNumber = c.lineNumber;
+        pool.submit([&shared, &completions, key, sequence, lineNumber, line = std::move(line)] {
+            completions.push({key, sequence, answerLine(shared, line, lineNumber)});
+        });
+    }
+
+    // Descarta o que já foi consumido
+    if (c.inputStart > 0 && c.inputStart * 2 >= c.input.size()) {
+        c.input.erase(0, c.inputStart);
+        c.inputStart = 0;
+    }
+}
+
+/**
+ * @brief Reads everything available on a connection.
+ */
+static void readInput(Connection& c) {
+    char chunk[65536];
+    while (true) {
+        ssize_t n = recv(c.fd, chunk, sizeof chunk, 0);
+        if (n > 0) {
+            c.input.append(chunk, (size_t)n);
+            if (c.input.size() - c.inputStart > maxLineLength + sizeof chunk) return;   // submitLines decide
+            continue;
+        }
+        if (n == 0) c.peerClosed = true;
+        else if (errno == EINTR) continue;
+        else if (errno != EAGAIN && errno != EWOULDBLOCK) c.broken = true;
+        return;
+    }
+}
+
+/**
+ * @brief Sends as much of the pending output of a connection as the socket accepts.
+ */
+static void writeOutput(Connection& c) {
+    while (c.pendingOutput() > 0) {
+        ssize_t n = send(c.fd, c.output.data() + c.outputSent, c.pendingOutput(), MSG_NOSIGNAL);
+        if (n > 0) {
+            c.outputSent += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) c.broken = true;
+        break;
+    }
+    if (c.outputSent == c.output.size()) {
+        c.output.clear();
+        c.outputSent = 0;
+    } else if (c.outputSent * 2 >= c.output.size()) {
+        c.output.erase(0, c.outputSent);
+        c.outputSent = 0;
+    }
+}
+
+/**
+ * @brief Serves routing requests on a Unix domain socket until SIGINT or SIGTERM; SIGHUP reloads the network and SIGUSR1 updates it.
+ *
+ * @param shared The network, which may be replaced while serving.
+ * @param socketPath The path of the socket.
+ * @param threads The number of worker threads; 0 uses one per hardware thread.
+ * @return 0 after a clean shutdown, 1 if the socket could not be set up.
+ *
+ * @note Time Complexity: O(q / t) per request, where q is its cost and t the number of threads.
+ */
+int runServer(SharedNetwork& shared, const string& socketPath, int threads) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof address.sun_path) {
+        cerr << "Caminho do socket demasiado longo: " << socketPath << endl;
+        return 1;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    // SIGINT/SIGTERM/SIGHUP/SIGUSR1 chegam pelo signalfd; bloqueados antes de criar as threads, que herdam a máscara
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(socketPath.c_str());
+    if (listenFd < 0 || bind(listenFd, (sockaddr*)&address, sizeof address) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+        cerr << "Erro ao abrir o socket " << socketPath << ": " << strerror(errno) << endl;
+        if (listenFd >= 0) close(listenFd);
+        return 1;
+    }
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    int wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    auto watch = [&](int fd, uint32_t events, uint64_t key, int op) {
+        epoll_event ev = {};
+        ev.events = events;
+        ev.data.u64 = key;
+        return epoll_ctl(epollFd, op, fd, &ev) == 0;
+    };
+    if (epollFd < 0 || wakeFd < 0 || signalFd < 0 || !watch(listenFd, EPOLLIN, listenKey, EPOLL_CTL_ADD) ||
+        !watch(wakeFd, EPOLLIN, wakeKey, EPOLL_CTL_ADD) || !watch(signalFd, EPOLLIN, signalKey, EPOLL_CTL_ADD)) {
+        cerr << "Erro ao iniciar o epoll: " << strerror(errno) << endl;
+        return 1;
+    }
+
+    CompletionQueue completions(wakeFd);    // declarada antes do pool: as tarefas usam-na até ao fim
+    WorkStealingPool pool(threads);
+    unordered_map<uint64_t, unique_ptr<Connection>> connections;
+    uint64_t nextKey = 3;
+    bool stopping = false;
+    auto deadline = chrono::steady_clock::time_point::max();
+    cerr << "A servir em " << socketPath << " com " << pool.size() << " threads." << endl;
+
+    // Ajusta os eventos de uma ligação ao seu estado, ou fecha-a
+    auto update = [&](uint64_t key, Connection& c) {
+        bool finished = c.peerClosed && c.inputStart == c.input.size() && c.inFlight() == 0 && c.pendingOutput() == 0;
+        if (c.broken || finished) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+            close(c.fd);
+            connections.erase(key);
+            return;
+        }
+        uint32_t events = 0;
+        if (!c.peerClosed && !stopping && c.inFlight() < maxInFlight && c.pendingOutput() < maxPendingOutput)
+            events |= EPOLLIN | EPOLLRDHUP;
+        if (c.pendingOutput() > 0) events |= EPOLLOUT;
+        if (events != c.events) {
+            watch(c.fd, events, key, EPOLL_CTL_MOD);
+            c.events = events;
+        }
+    };
+
+    epoll_event events[64];
+    while (true) {
+        if (stopping) {
+            // Termina depois de enviar as respostas em curso (ou ao fim do prazo)
+            bool pending = false;
+            for (auto& [key, c] : connections) pending = pending || c->inFlight() > 0 || c->pendingOutput() > 0;
+            if (!pending || chrono::steady_clock::now() >= deadline) break;
+        }
+
+        int count = epoll_wait(epollFd, events, 64, stopping ? 100 : -1);
+        if (count < 0 && errno != EINTR) break;
+
+        for (int i = 0; i < count; ++i) {
+            uint64_t key = events[i].data.u64;
+            if (key == listenKey) {
+                // Aceita todas as ligações pendentes
+                while (true) {
+                    int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd < 0) break;
+                    auto c = make_unique<Connection>();
+                    c->fd = fd;
+                    c->events = EPOLLIN | EPOLLRDHUP;
+                    if (!watch(fd, c->events, nextKey, EPOLL_CTL_ADD)) {
+                        close(fd);
+                        continue;
+                    }
+                    connections[nextKey++] = std::move(c);
+                }
+            } else if (key == wakeKey) {
+                // Respostas terminadas: seguem pela ordem dos pedidos de cada ligação
+                uint64_t counter;
+                ssize_t ignored = read(wakeFd, &counter, sizeof counter);
+                (void)ignored;
+                for (Completion& done : completions.take()) {
+                    auto it = connections.find(done.connection);
+                    if (it == connections.end()) continue;   // a ligação já fechou
+                    Connection& c = *it->second;
+                    c.ready[done.sequence] = std::move(done.response);
+                    while (!c.ready.empty() && c.ready.begin()->first == c.nextWrite) {
+                        c.output += c.ready.begin()->second;
+                        c.ready.erase(c.ready.begin());
+                        c.nextWrite++;
+                    }
+                    writeOutput(c);
+                    if (!stopping) submitLines(shared, pool, completions, done.connection, c);
+                    update(done.connection, c);
+                }
+            } else if (key == signalKey) {
+                signalfd_siginfo info;
+                if (read(signalFd, &info, sizeof info) != (ssize_t)sizeof info) continue;
+                if (info.ssi_signo == SIGHUP) {
+                    // Recarga em segundo plano; os pedidos continuam na rede atual até à publicação
+                    if (stopping) continue;
+                    bool started = shared.reload([](bool loaded) {
+                        cerr << (loaded ? "Rede recarregada." : "Erro ao recarregar a rede; mantém-se a anterior.") << endl;
+                    });
+                    cerr << (started ? "A recarregar a rede..." : "Recarga ignorada (já em curso ou indisponível).") << endl;
+                    continue;
+                }
+                if (info.ssi_signo == SIGUSR1) {
+                    // Atualização de tempos sobre uma cópia da rede atual, publicada no fim
+                    if (stopping) continue;
+                    bool started = shared.update([](bool updated) {
+                        if (!updated) cerr << "Erro ao atualizar a rede; mantém-se a anterior." << endl;
+                    });
+                    if (!started) cerr << "Atualização ignorada (já em curso ou indisponível)." << endl;
+                    continue;
+                }
+                stopping = true;
+                deadline = chrono::steady_clock::now() + chrono::seconds(5);
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+                vector<uint64_t> keys;
+                for (auto& entry : connections) keys.push_back(entry.first);
+                for (uint64_t connKey : keys) update(connKey, *connections[connKey]);
+                break;   // as ligações podem ter mudado
+            } else {
+                auto it = connections.find(key);
+                if (it == connections.end()) continue;
+                Connection& c = *it->second;
+                uint32_t ev = events[i].events;
+                if (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+                    readInput(c);
+                    submitLines(shared, pool, completions, key, c);
+                }
+                if (ev & EPOLLOUT) writeOutput(c);
+                if (ev & (EPOLLERR | EPOLLHUP)) c.broken = true;   // já não é possível responder
+                update(key, c);
+            }
+        }
+    }
+
+    // Fecha tudo; as tarefas ainda em curso terminam no destrutor do pool
+    for (auto& [key, c] : connections) close(c->fd);
+    close(listenFd);
+    unlink(socketPath.c_str());
+    pool.wait();
+    close(signalFd);
+    close(epollFd);
+    close(wakeFd);
+    cerr << "Servidor terminado." << endl;
+    return 0;
+}
+
+#else
+
+int runServer(SharedNetwork&, const std::string&, int) {
+    std::cerr << "O modo servidor só está disponível em Linux." << std::endl;
+    return 1;
+}
+
+#endif
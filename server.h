@@ -0,0 +1,34 @@
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <string>
+#include "sharednetwork.h"
+
+/**
+ * @brief Serves routing requests on a Unix domain socket until SIGINT or SIGTERM.
+ *
+ * Every request runs on the network that is current when it starts (see `SharedNetwork`).
+ * SIGHUP reloads the network in the background: requests keep being answered from the old
+ * network until the new one is published, and those already running finish on the old one.
+ * SIGUSR1 does the same with `SharedNetwork::update` (e.g. new travel times). The protocol
+ * is the JSON Lines format of `processJsonlFile`: a client writes one request object per line
+ * and reads one response line per request, in the order the requests were sent. Clients may
+ * pipeline: every complete line is handed to the worker pool as soon as it arrives, so many
+ * requests of one connection are answered concurrently, and the responses are queued back in
+ * order. Invalid lines get `{"line":n,"error":"..."}` (n counts the lines of the connection);
+ * `matrixFile` is refused, since the server does not write files on behalf of its clients.
+ *
+ * One thread runs an epoll loop over the listening socket, the connections, an eventfd that
+ * signals finished requests and a signalfd; it never blocks on a search. A connection with too
+ * many requests in flight is not read until some of them finish.
+ *
+ * @param shared The network, which SIGHUP replaces by a freshly loaded one and SIGUSR1 by an updated one.
+ * @param socketPath The path of the socket (an existing file at that path is replaced).
+ * @param threads The number of worker threads; 0 uses one per hardware thread.
+ * @return 0 after a clean shutdown, 1 if the socket could not be set up (or on systems without epoll).
+ *
+ * @note Time Complexity: O(q / t) per request, where q is its cost and t the number of threads.
+ */
+int runServer(SharedNetwork& shared, const std::string& socketPath, int threads = 0);
+
+#endif
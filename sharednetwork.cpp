@@ -0,0 +1,109 @@
+#include "sharednetwork.h"
+
+// Contador global: uma versão identifica um único publish, seja de que SharedNetwork for
+static atomic<uint64_t> nextVersion{1};
+
+// Serializa os publish (só escritores): a versão publicada corresponde sempre ao ponteiro publicado
+static mutex publishLock;
+
+/**
+ * @brief Publishes the initial network.
+ *
+ * @param initial The network to serve first.
+ * @param loader Builds a new network for `reload`.
+ * @param updater Patches a copy of the current network for `update`.
+ */
+SharedNetwork::SharedNetwork(shared_ptr<const Network> initial, function<bool(Network&)> loader,
+                             function<bool(Network&)> updater)
+    : current(std::move(initial)), published(nextVersion++), loader(std::move(loader)), updater(std::move(updater)) {}
+
+/**
+ * @brief Waits for a reload or update in progress to finish.
+ */
+SharedNetwork::~SharedNetwork() {
+    lock_guard<mutex> guard(reloadLock);
+    if (reloader.joinable()) reloader.join();
+}
+
+/**
+ * @brief Returns the current network, to be held for the duration of one query.
+ *
+ * @return The network published last (as seen by this thread).
+ *
+ * @note Time Complexity: O(1); one atomic load unless a new network was published since the thread's last call.
+ */
+shared_ptr<const Network> SharedNetwork::acquire() const {
+    // Cópia por thread da última rede vista; só se volta a ler o shared_ptr quando a versão muda
+    static thread_local uint64_t cachedVersion = 0;
+    static thread_local shared_ptr<const Network> cached;
+
+    uint64_t version = published.load(memory_order_acquire);
+    if (version != cachedVersion) {
+        cached = atomic_load(&current);   // pelo menos tão recente como `version`
+        cachedVersion = version;
+    }
+    return cached;
+}
+
+/**
+ * @brief Replaces the current network. Queries already running keep the old one.
+ *
+ * @param next The new network.
+ *
+ * @note Time Complexity: O(1); the old network is freed by the last query that holds it.
+ */
+void SharedNetwork::publish(shared_ptr<const Network> next) {
+    lock_guard<mutex> guard(publishLock);
+    atomic_store(&current, std::move(next));
+    published.store(nextVersion++, memory_order_release);
+}
+
+/**
+ * @brief Builds a network on a background thread, then publishes it.
+ *
+ * @param build Fills the network; returns false to discard it.
+ * @param fromCurrent True to start from a copy of the current network, false from an empty one.
+ * @param done Called on the background thread with the outcome, after publishing.
+ * @return False if a reload or update is already running.
+ *
+ * @note Time Complexity: O(1) on the calling thread.
+ */
+bool SharedNetwork::startJob(function<bool(Network&)> build, bool fromCurrent, function<void(bool)> done) {
+    lock_guard<mutex> guard(reloadLock);
+    if (reloading.exchange(true)) return false;
+    if (reloader.joinable()) reloader.join();   // o trabalho anterior já terminou
+
+    reloader = thread([this, build = std::move(build), fromCurrent, done = std::move(done)] {
+        // Só este thread publica enquanto `reloading` estiver ativo: a cópia parte da versão atual
+        auto next = fromCurrent ? make_shared<Network>(*atomic_load(&current)) : make_shared<Network>();
+        bool built = build(*next);
+        if (built) publish(std::move(next));
+        reloading.store(false);
+        if (done) done(built);
+    });
+    return true;
+}
+
+/**
+ * @brief Builds a new network with the loader on a background thread, then publishes it.
+ *
+ * @param done Called on the background thread with the outcome, after publishing.
+ * @return False if there is no loader or a reload or update is already running.
+ *
+ * @note Time Complexity: O(1) on the calling thread; the reload costs a full load.
+ */
+bool SharedNetwork::reload(function<void(bool)> done) {
+    return loader && startJob(loader, false, std::move(done));
+}
+
+/**
+ * @brief Copies the current network, patches the copy with the updater on a background thread, then publishes it.
+ *
+ * @param done Called on the background thread with the outcome, after publishing.
+ * @return False if there is no updater or a reload or update is already running.
+ *
+ * @note Time Complexity: O(1) on the calling thread; the update costs a copy of the owned arrays plus the patch.
+ */
+bool SharedNetwork::update(function<void(bool)> done) {
+    return updater && startJob(updater, true, std::move(done));
+}
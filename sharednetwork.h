@@ -0,0 +1,110 @@
+#ifndef SHAREDNETWORK_HPP
+#define SHAREDNETWORK_HPP
+
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+#include "network.h"
+
+using namespace std;
+
+/**
+ * @class SharedNetwork
+ * @brief The current network of a long-running process, replaceable while queries run.
+ *
+ * The network (graph, symbol table and preprocessing) is published as an immutable,
+ * reference-counted snapshot. A query pins the snapshot that is current when it starts and
+ * keeps using it to the end, so a reload never changes the data under a running search; the
+ * old snapshot is freed when its last query finishes.
+ *
+ * The read side takes no lock: every thread caches the snapshot it last saw together with the
+ * version number it was published under, and `acquire` only compares that number with the
+ * current one (a single atomic load). The shared pointer itself is only read again after a
+ * publish. Because of that cache, a thread keeps its last snapshot alive until its next
+ * `acquire`, even when it has nothing left to run.
+ *
+ * Reloads run on a background thread with a loader function that builds a whole new network
+ * (e.g. from the CSV files), then publish it; queries continue on the old network meanwhile.
+ * Updates work the same way, but patch a copy of the current network with an updater function
+ * (e.g. new travel times), which is far cheaper than a reload: the copy shares the unchanged
+ * preprocessing and the arrays viewing a mapped snapshot.
+ */
+class SharedNetwork {
+private:
+    shared_ptr<const Network> current;        // só lido/escrito com atomic_load/atomic_store
+    atomic<uint64_t> published;               // versão de `current`
+    function<bool(Network&)> loader;
+    function<bool(Network&)> updater;
+
+    mutex reloadLock;                         // protege `reloader` (nunca tocado pelas consultas)
+    thread reloader;
+    atomic<bool> reloading{false};            // uma recarga ou atualização em curso
+
+    bool startJob(function<bool(Network&)> build, bool fromCurrent, function<void(bool)> done);
+
+public:
+    /**
+     * @brief Publishes the initial network.
+     *
+     * @param initial The network to serve first.
+     * @param loader Builds a new network for `reload`; returns false (leaving the current network in place) if it fails.
+     * @param updater Patches a copy of the current network for `update`; returns false to discard the copy.
+     */
+    explicit SharedNetwork(shared_ptr<const Network> initial, function<bool(Network&)> loader = {},
+                           function<bool(Network&)> updater = {});
+
+    /**
+     * @brief Waits for a reload or update in progress to finish.
+     */
+    ~SharedNetwork();
+
+    SharedNetwork(const SharedNetwork&) = delete;
+    SharedNetwork& operator=(const SharedNetwork&) = delete;
+
+    /**
+     * @brief Returns the current network, to be held for the duration of one query.
+     *
+     * @note Time Complexity: O(1); one atomic load unless a new network was published since the thread's last call.
+     */
+    shared_ptr<const Network> acquire() const;
+
+    /**
+     * @brief Replaces the current network. Queries already running keep the old one.
+     *
+     * @note Time Complexity: O(1).
+     */
+    void publish(shared_ptr<const Network> next);
+
+    /**
+     * @brief Builds a new network with the loader on a background thread, then publishes it.
+     *
+     * @param done Called on the background thread with the outcome, after publishing.
+     * @return False if there is no loader or a reload or update is already running (nothing is started).
+     */
+    bool reload(function<void(bool)> done = {});
+
+    /**
+     * @brief Copies the current network, patches the copy with the updater on a background thread, then publishes it.
+     *
+     * @param done Called on the background thread with the outcome, after publishing.
+     * @return False if there is no updater or a reload or update is already running (nothing is started).
+     */
+    bool update(function<void(bool)> done = {});
+
+    /**
+     * @brief Returns true while a reload or update is running.
+     */
+    bool reloadInProgress() const { return reloading.load(); }
+
+    /**
+     * @brief Returns the version of the current network.
+     *
+     * Versions come from one process-wide counter, so no two publishes (of any SharedNetwork) share one.
+     */
+    uint64_t version() const { return published.load(memory_order_acquire); }
+};
+
+#endif
@@ -0,0 +1,355 @@
+#include "snapshot.h"
+#include "mappedfile.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+/**
+ * @brief Identifies the contents of a section.
+ */
+enum SnapshotSectionId : uint32_t {
+    SymbolCodeOffsets = 1, SymbolCodeBytes, SymbolNameOffsets, SymbolNameBytes,
+    SymbolLocationIds, SymbolParking,
+    GraphOffsets, GraphTargets, GraphWeights,
+    LandmarkNodes, LandmarkDistances,
+    ChRanks, ChOffsets, ChArcs,
+    CchRank, CchByRank, CchParent, CchUpOffsets, CchUpTargets,
+    CchDownOffsets, CchDownSources, CchDownArcs, CchInputArc,
+    CchMetricInput, CchMetricWeight
+};
+
+struct SnapshotHeader {
+    char magic[8];           // "TTSNAP\0\0"
+    uint32_t version;
+    uint32_t sectionCount;
+    uint64_t checksum;       // de tudo o que vem depois do cabeçalho
+    uint64_t size;           // tamanho total do ficheiro
+};
+
+struct SnapshotSection {
+    uint32_t id;
+    uint32_t elementSize;    // confirma que o tipo tem o mesmo tamanho em memória
+    uint64_t offset;         // desde o início do ficheiro, múltiplo de 8
+    uint64_t count;          // número de elementos
+};
+
+static const char snapshotMagic[8] = {'T', 'T', 'S', 'N', 'A', 'P', 0, 0};
+
+/**
+ * @brief Computes the checksum stored in a snapshot header.
+ *
+ * @param data The bytes covered by the checksum.
+ * @return The 64-bit FNV-1a hash of the data, taken eight bytes at a time.
+ *
+ * @note Time Complexity: O(n), where n is the number of bytes.
+ */
+uint64_t snapshotChecksum(string_view data) {
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL;
+    size_t words = data.size() / 8;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t word;
+        memcpy(&word, data.data() + i * 8, 8);
+        hash = (hash ^ word) * prime;
+    }
+    for (size_t i = words * 8; i < data.size(); ++i)
+        hash = (hash ^ (unsigned char)data[i]) * prime;
+    return hash;
+}
+
+/**
+ * @brief A section waiting to be written: its ID and the bytes of its array.
+ */
+struct PendingSection {
+    uint32_t id;
+    uint32_t elementSize;
+    const void* data;
+    uint64_t count;
+};
+
+template <class T>
+static void addSection(vector<PendingSection>& sections, uint32_t id, const T* data, size_t count) {
+    sections.push_back({id, (uint32_t)sizeof(T), data, (uint64_t)count});
+}
+
+/**
+ * @brief Writes a network to a binary snapshot file.
+ *
+ * The sections are written after a provisional header; the file is then mapped to compute
+ * the checksum, and the final header is written over the provisional one.
+ *
+ * @param net The network.
+ * @param path The path of the snapshot file.
+ * @return False if the file could not be written.
+ *
+ * @note Time Complexity: O(V + E + P), where P is the size of the preprocessing.
+ */
+bool saveSnapshot(const Network& net, const string& path) {
+    const Graph& g = net.graph;
+    const SymbolTable& symbols = g.symbols();
+    int n = g.nodeCount();
+
+    // Tabela de símbolos em arrays planos: textos concatenados + offsets
+    vector<uint64_t> codeOffsets(n + 1, 0), nameOffsets(n + 1, 0);
+    string codeBytes, nameBytes;
+    vector<int> locationIds(n);
+    vector<uint8_t> parking(n);
+    for (int v = 0; v < n; ++v) {
+        codeBytes += symbols.code(v);
+        nameBytes += symbols.name(v);
+        codeOffsets[v + 1] = codeBytes.size();
+        nameOffsets[v + 1] = nameBytes.size();
+        locationIds[v] = symbols.locationId(v);
+        parking[v] = symbols.hasParking(v);
+    }
+
+    vector<PendingSection> sections;
+    addSection(sections, SymbolCodeOffsets, codeOffsets.data(), codeOffsets.size());
+    addSection(sections, SymbolCodeBytes, codeBytes.data(), codeBytes.size());
+    addSection(sections, SymbolNameOffsets, nameOffsets.data(), nameOffsets.size());
+    addSection(sections, SymbolNameBytes, nameBytes.data(), nameBytes.size());
+    addSection(sections, SymbolLocationIds, locationIds.data(), locationIds.size());
+    addSection(sections, SymbolParking, parking.data(), parking.size());
+
+    addSection(sections, GraphOffsets, g.arcOffsets().data(), g.arcOffsets().size());
+    addSection(sections, GraphTargets, g.arcTargets().data(), g.arcTargets().size());
+    addSection(sections, GraphWeights, g.arcWeights().data(), g.arcWeights().size());
+
+    if (net.landmarks) {
+        const LandmarkTable& lt = *net.landmarks;
+        addSection(sections, LandmarkNodes, lt.landmarks().data(), lt.landmarks().size());
+        addSection(sections, LandmarkDistances, lt.distances().data(), lt.distances().size());
+    }
+    if (net.ch) {
+        addSection(sections, ChRanks, net.ch->ranks().data(), net.ch->ranks().size());
+        addSection(sections, ChOffsets, net.ch->arcOffsets().data(), net.ch->arcOffsets().size());
+        addSection(sections, ChArcs, net.ch->upwardArcs().data(), net.ch->upwardArcs().size());
+    }
+    if (net.cch) {
+        const CchTopology& t = *net.cch;
+        addSection(sections, CchRank, t.rank.data(), t.rank.size());
+        addSection(sections, CchByRank, t.byRank.data(), t.byRank.size());
+        addSection(sections, CchParent, t.etreeParent.data(), t.etreeParent.size());
+        addSection(sections, CchUpOffsets, t.upOffsets.data(), t.upOffsets.size());
+        addSection(sections, CchUpTargets, t.upTargets.data(), t.upTargets.size());
+        addSection(sections, CchDownOffsets, t.downOffsets.data(), t.downOffsets.size());
+        addSection(sections, CchDownSources, t.downSources.data(), t.downSources.size());
+        addSection(sections, CchDownArcs, t.downArcs.data(), t.downArcs.size());
+        addSection(sections, CchInputArc, t.inputArc.data(), t.inputArc.size());
+        if (net.cchMetric) {
+            addSection(sections, CchMetricInput, net.cchMetric->input.data(), net.cchMetric->input.size());
+            addSection(sections, CchMetricWeight, net.cchMetric->weight.data(), net.cchMetric->weight.size());
+        }
+    }
+
+    // Posição de cada secção: depois do cabeçalho e da tabela, alinhada a 8 bytes
+    vector<SnapshotSection> table(sections.size());
+    uint64_t offset = sizeof(SnapshotHeader) + sections.size() * sizeof(SnapshotSection);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        offset = (offset + 7) & ~uint64_t(7);
+        table[i] = {sections[i].id, sections[i].elementSize, offset, sections[i].count};
+        offset += sections[i].count * sections[i].elementSize;
+    }
+    uint64_t size = (offset + 7) & ~uint64_t(7);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, snapshotMagic, sizeof header.magic);
+    header.version = snapshotVersion;
+    header.sectionCount = (uint32_t)sections.size();
+    header.size = size;
+
+    bool ok = fwrite(&header, sizeof header, 1, file) == 1;
+    if (!table.empty()) ok = ok && fwrite(table.data(), sizeof(SnapshotSection), table.size(), file) == table.size();
+    uint64_t written = sizeof(SnapshotHeader) + table.size() * sizeof(SnapshotSection);
+    static const char padding[8] = {};
+    for (size_t i = 0; i < sections.size() && ok; ++i) {
+        ok = fwrite(padding, 1, table[i].offset - written, file) == table[i].offset - written;
+        size_t bytes = sections[i].count * sections[i].elementSize;
+        if (bytes > 0) ok = ok && fwrite(sections[i].data, 1, bytes, file) == bytes;
+        written = table[i].offset + bytes;
+    }
+    ok = ok && fwrite(padding, 1, size - written, file) == size - written;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) return false;
+
+    // Checksum sobre o ficheiro escrito; o cabeçalho final substitui o provisório
+    {
+        MappedFile mapped(path, true);
+        if (!mapped.good() || mapped.size() != size) return false;
+        header.checksum = snapshotChecksum(mapped.data().substr(sizeof(SnapshotHeader)));
+    }
+    file = fopen(path.c_str(), "r+b");
+    if (!file) return false;
+    ok = fwrite(&header, sizeof header, 1, file) == 1;
+    return (fclose(file) == 0) && ok;
+}
+
+/**
+ * @brief Reads the section table of a mapped snapshot.
+ */
+class SnapshotSections {
+private:
+    const char* base;
+    vector<SnapshotSection> table;
+
+public:
+    SnapshotSections(const char* base, vector<SnapshotSection> table) : base(base), table(std::move(table)) {}
+
+    /**
+     * @brief Returns whether a section is present.
+     */
+    bool has(uint32_t id) const {
+        for (const auto& s : table) {
+            if (s.id == id) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns a section as a view of elements of type T.
+     *
+     * @param ok Set to false if the section is missing or its elements are not of type T.
+     */
+    template <class T>
+    FlatArray<T> view(uint32_t id, bool& ok) const {
+        for (const auto& s : table) {
+            if (s.id != id) continue;
+            if (s.elementSize != sizeof(T)) break;
+            return FlatArray<T>::view(reinterpret_cast<const T*>(base + s.offset), (size_t)s.count);
+        }
+        ok = false;
+        return FlatArray<T>();
+    }
+};
+
+/**
+ * @brief Loads a network from a binary snapshot file.
+ *
+ * @param path The path of the snapshot file.
+ * @param net Receives the network.
+ * @param verify True to check the checksum.
+ * @return False if the file is missing, of another version, corrupt or inconsistent.
+ *
+ * @note Time Complexity: O(V) for the symbol table, plus O(size) when verifying.
+ */
+bool loadSnapshot(const string& path, Network& net, bool verify) {
+    auto mapped = make_shared<MappedFile>(path);
+    string_view data = mapped->data();
+    auto fail = [&](const char* reason) {
+        cerr << path << ": " << reason << endl;
+        return false;
+    };
+
+    // Cabeçalho, versão e tamanho
+    if (!mapped->good()) return fail("não foi possível abrir o snapshot.");
+    SnapshotHeader header;
+    if (data.size() < sizeof header) return fail("snapshot truncado.");
+    memcpy(&header, data.data(), sizeof header);
+    if (memcmp(header.magic, snapshotMagic, sizeof header.magic) != 0) return fail("não é um snapshot.");
+    if (header.version != snapshotVersion) return fail("versão de snapshot não suportada.");
+    if (header.size != data.size()) return fail("snapshot truncado.");
+    if (verify && snapshotChecksum(data.substr(sizeof header)) != header.checksum) return fail("checksum inválido.");
+
+    // Tabela de secções: cada secção tem de estar alinhada e dentro do ficheiro
+    uint64_t tableEnd = sizeof header + (uint64_t)header.sectionCount * sizeof(SnapshotSection);
+    if (tableEnd > data.size()) return fail("tabela de secções inválida.");
+    vector<SnapshotSection> table(header.sectionCount);
+    if (!table.empty()) memcpy(table.data(), data.data() + sizeof header, table.size() * sizeof(SnapshotSection));
+    for (const auto& s : table) {
+        if (s.offset % 8 != 0 || s.offset < tableEnd || s.offset > data.size() || s.elementSize == 0 ||
+            s.count > (data.size() - s.offset) / s.elementSize)
+            return fail("secção fora do ficheiro.");
+    }
+    SnapshotSections sections(data.data(), std::move(table));
+    bool ok = true;
+
+    // Tabela de símbolos (copiada: o índice de códigos é uma tabela de dispersão)
+    auto codeOffsets = sections.view<uint64_t>(SymbolCodeOffsets, ok);
+    auto codeBytes = sections.view<char>(SymbolCodeBytes, ok);
+    auto nameOffsets = sections.view<uint64_t>(SymbolNameOffsets, ok);
+    auto nameBytes = sections.view<char>(SymbolNameBytes, ok);
+    auto locationIds = sections.view<int>(SymbolLocationIds, ok);
+    auto parking = sections.view<uint8_t>(SymbolParking, ok);
+    size_t n = locationIds.size();
+    if (!ok || codeOffsets.size() != n + 1 || nameOffsets.size() != n + 1 || parking.size() != n ||
+        codeOffsets[n] > codeBytes.size() || nameOffsets[n] > nameBytes.size())
+        return fail("tabela de símbolos inválida.");
+
+    vector<Location> locations(n);
+    for (size_t v = 0; v < n; ++v) {
+        if (codeOffsets[v] > codeOffsets[v + 1] || nameOffsets[v] > nameOffsets[v + 1])
+            return fail("tabela de símbolos inválida.");
+        locations[v].code.assign(codeBytes.data() + codeOffsets[v], codeOffsets[v + 1] - codeOffsets[v]);
+        locations[v].name.assign(nameBytes.data() + nameOffsets[v], nameOffsets[v + 1] - nameOffsets[v]);
+        locations[v].id = locationIds[v];
+        locations[v].hasParking = parking[v] != 0;
+    }
+    SymbolTable symbols(locations);
+    if ((size_t)symbols.size() != n) return fail("códigos repetidos na tabela de símbolos.");
+
+    // Grafo em CSR: vistas sobre o ficheiro
+    auto offsets = sections.view<int>(GraphOffsets, ok);
+    auto targets = sections.view<int>(GraphTargets, ok);
+    auto weights = sections.view<EdgeData>(GraphWeights, ok);
+    if (!ok || offsets.size() != n + 1 || offsets[0] != 0 || (size_t)offsets[n] != targets.size() ||
+        weights.size() != targets.size())
+        return fail("grafo inválido.");
+
+    Network loaded;
+    loaded.snapshot = mapped;
+    loaded.graph.assign(std::move(symbols), std::move(offsets), std::move(targets), std::move(weights));
+
+    // Pré-processamentos presentes no snapshot
+    if (sections.has(LandmarkNodes)) {
+        auto nodes = sections.view<int>(LandmarkNodes, ok);
+        auto distances = sections.view<int>(LandmarkDistances, ok);
+        if (!ok || distances.size() != nodes.size() * n) return fail("tabela de landmarks inválida.");
+        loaded.landmarks = make_shared<LandmarkTable>((int)n, std::move(nodes), std::move(distances));
+    }
+    if (sections.has(ChRanks)) {
+        auto ranks = sections.view<int>(ChRanks, ok);
+        auto chOffsets = sections.view<int>(ChOffsets, ok);
+        auto arcs = sections.view<ChArc>(ChArcs, ok);
+        if (!ok || ranks.size() != n || chOffsets.size() != n + 1 || (size_t)chOffsets[n] != arcs.size())
+            return fail("hierarquia inválida.");
+        loaded.ch = make_shared<ContractionHierarchy>(std::move(ranks), std::move(chOffsets), std::move(arcs));
+    }
+    if (sections.has(CchRank)) {
+        auto topology = make_shared<CchTopology>();
+        topology->rank = sections.view<int>(CchRank, ok);
+        topology->byRank = sections.view<int>(CchByRank, ok);
+        topology->etreeParent = sections.view<int>(CchParent, ok);
+        topology->upOffsets = sections.view<int>(CchUpOffsets, ok);
+        topology->upTargets = sections.view<int>(CchUpTargets, ok);
+        topology->downOffsets = sections.view<int>(CchDownOffsets, ok);
+        topology->downSources = sections.view<int>(CchDownSources, ok);
+        topology->downArcs = sections.view<int>(CchDownArcs, ok);
+        topology->inputArc = sections.view<int>(CchInputArc, ok);
+        if (!ok || topology->rank.size() != n || topology->upOffsets.size() != n + 1 ||
+            (size_t)topology->upOffsets[n] != topology->upTargets.size() ||
+            topology->inputArc.size() != loaded.graph.arcTargets().size())
+            return fail("hierarquia customizável inválida.");
+
+        // A métrica é copiada: pode ser recustomizada depois de carregada
+        if (sections.has(CchMetricInput)) {
+            auto input = sections.view<int>(CchMetricInput, ok);
+            auto weight = sections.view<int>(CchMetricWeight, ok);
+            if (!ok || input.size() != topology->upTargets.size() || weight.size() != input.size())
+                return fail("métrica da hierarquia customizável inválida.");
+            loaded.cchMetric = make_shared<CchMetric>(CchMetric{vector<int>(input.begin(), input.end()),
+                                                                vector<int>(weight.begin(), weight.end())});
+        } else {
+            loaded.cchMetric = make_shared<CchMetric>(customizeCch(*topology, loaded.graph, {}, {}));
+        }
+        loaded.cch = topology;
+    }
+
+    net = std::move(loaded);
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "network.h"
+
+/**
+ * @brief Version of the snapshot format; files with another version are rejected.
+ */
+const uint32_t snapshotVersion = 1;
+
+/**
+ * @brief Computes the checksum stored in a snapshot header.
+ *
+ * 64-bit FNV-1a over the data taken eight bytes at a time (then the remaining bytes).
+ *
+ * @param data The bytes covered by the checksum.
+ * @return The checksum.
+ *
+ * @note Time Complexity: O(n), where n is the number of bytes.
+ */
+uint64_t snapshotChecksum(std::string_view data);
+
+/**
+ * @brief Writes a network to a binary snapshot file.
+ *
+ * The file holds a header (magic "TTSNAP", format version, checksum and size), a table of
+ * sections, then the sections themselves, each aligned to 8 bytes: the symbol table (codes,
+ * names, location IDs, parking flags), the CSR arrays of the graph and, when the network has
+ * them, the landmark table, the contraction hierarchy and the CCH topology and metric. Arrays
+ * are written exactly as they are laid out in memory (native byte order), so that
+ * `loadSnapshot` can use them in place.
+ *
+ * @param net The network.
+ * @param path The path of the snapshot file.
+ * @return False if the file could not be written.
+ *
+ * @note Time Complexity: O(V + E + P), where P is the size of the preprocessing.
+ */
+bool saveSnapshot(const Network& net, const std::string& path);
+
+/**
+ * @brief Loads a network from a binary snapshot file.
+ *
+ * The file is memory-mapped read-only and the arrays of the graph and of the preprocessing
+ * become views into the mapping (`Network::snapshot` keeps it alive), so nothing but the
+ * symbol table and the CCH metric is copied and pages are only read when a query touches
+ * them. Several processes loading the same snapshot share its pages in the page cache.
+ *
+ * @param path The path of the snapshot file.
+ * @param net Receives the network; it is only modified if the snapshot is valid.
+ * @param verify True to check the checksum, which reads the whole file once.
+ * @return False (with a message on cerr) if the file is missing, of another version, corrupt or inconsistent.
+ *
+ * @note Time Complexity: O(V) for the symbol table, plus O(size) when verifying.
+ */
+bool loadSnapshot(const std::string& path, Network& net, bool verify = true);
+
+#endif
@@ -0,0 +1,57 @@
+#include "symbols.h"
+
+/**
+ * @brief Creates a symbol table holding every location of the locations file.
+ *
+ * @param locations The locations produced by `parseLocations`.
+ *
+ * @note Time Complexity: O(n), where n is the number of locations.
+ */
+SymbolTable::SymbolTable(const vector<Location>& locations) {
+    index.reserve(locations.size());
+    for (const auto& loc : locations) {
+        int node = intern(loc.code);
+        names[node] = loc.name;
+        locationIds[node] = loc.id;
+        parking[node] = loc.hasParking;
+
+        if (loc.id < 0) continue;
+        if (loc.id >= (int)byLocationId.size())
+            byLocationId.resize(loc.id + 1, -1);
+        byLocationId[loc.id] = node;
+    }
+}
+
+/**
+ * @brief Returns the node ID of a code, interning it if it is new.
+ *
+ * @param code The location code.
+ * @return The node ID of the code.
+ *
+ * @note Time Complexity: O(k) on average, where k is the length of the code.
+ */
+int SymbolTable::intern(string_view code) {
+    auto it = index.find(code);
+    if (it != index.end()) return it->second;
+
+    int node = (int)codes.size();
+    codes.emplace_back(code);
+    names.emplace_back();
+    locationIds.push_back(-1);
+    parking.push_back(0);
+    index.emplace(codes.back(), node);  // a chave aponta para a cópia guardada no deque
+    return node;
+}
+
+/**
+ * @brief Returns the node ID of a code.
+ *
+ * @param code The location code.
+ * @return The node ID, or -1 if the code was never interned.
+ *
+ * @note Time Complexity: O(k) on average, where k is the length of the code.
+ */
+int SymbolTable::find(string_view code) const {
+    auto it = index.find(code);
+    return it == index.end() ? -1 : it->second;
+}
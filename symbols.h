@@ -0,0 +1,108 @@
+#ifndef SYMBOLS_HPP
+#define SYMBOLS_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include "parser.h"
+
+using namespace std;
+
+/**
+ * @class SymbolTable
+ * @brief Interns location codes into dense integer node IDs.
+ *
+ * Every code is stored once, at load time. After that the rest of the program only handles
+ * node IDs, and the table answers node ↔ code ↔ name ↔ location ID lookups in O(1).
+ * Codes that appear in the distances file but not in the locations file are interned
+ * without a name, a location ID (-1) or parking.
+ */
+class SymbolTable {
+private:
+    deque<string> codes;                        // id -> código (deque: endereços estáveis)
+    vector<string> names;                       // id -> nome do local
+    vector<int> locationIds;                    // id -> ID do local no ficheiro, ou -1
+    vector<char> parking;                       // id -> tem parque?
+    unordered_map<string_view, int> index;      // código -> id
+    vector<int> byLocationId;                   // ID do local -> id, ou -1
+
+public:
+    SymbolTable() = default;
+
+    /**
+     * @brief Creates a table holding every location of the locations file.
+     *
+     * Node IDs are assigned in the order the locations appear.
+     *
+     * @param locations The locations produced by `parseLocations`.
+     *
+     * @note Time Complexity: O(n), where n is the number of locations.
+     */
+    explicit SymbolTable(const vector<Location>& locations);
+
+    // Copiar exigiria reconstruir o índice de string_view; mover é suficiente
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+    SymbolTable(SymbolTable&&) = default;
+    SymbolTable& operator=(SymbolTable&&) = default;
+
+    /**
+     * @brief Returns the node ID of a code, adding it to the table if needed.
+     *
+     * @param code The location code.
+     * @return The node ID of the code.
+     *
+     * @note Time Complexity: O(k) on average, where k is the length of the code.
+     */
+    int intern(string_view code);
+
+    /**
+     * @brief Returns the node ID of a code without modifying the table.
+     *
+     * @param code The location code.
+     * @return The node ID, or -1 if the code is unknown.
+     *
+     * @note Time Complexity: O(k) on average, where k is the length of the code.
+     */
+    int find(string_view code) const;
+
+    /**
+     * @brief Returns the node ID of the location with the given ID (as written in Locations.csv).
+     *
+     * @return The node ID, or -1 if there is no such location.
+     *
+     * @note Time Complexity: O(1).
+     */
+    int fromLocationId(int locationId) const {
+        return (locationId >= 0 && locationId < (int)byLocationId.size()) ? byLocationId[locationId] : -1;
+    }
+
+    /**
+     * @brief Returns the location ID (as written in Locations.csv) of a node, or -1.
+     */
+    int locationId(int node) const { return locationIds[node]; }
+
+    /**
+     * @brief Returns the location code of a node.
+     */
+    const string& code(int node) const { return codes[node]; }
+
+    /**
+     * @brief Returns the location name of a node (empty if the node has no location entry).
+     */
+    const string& name(int node) const { return names[node]; }
+
+    /**
+     * @brief Returns whether the location of a node has parking.
+     */
+    bool hasParking(int node) const { return parking[node]; }
+
+    /**
+     * @brief Returns the number of interned codes.
+     */
+    int size() const { return (int)codes.size(); }
+};
+
+#endif
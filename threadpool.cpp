@@ -0,0 +1,184 @@
+#include "threadpool.h"
+#include <algorithm>
+
+// Identifica o pool e o worker da thread atual (-1 fora de qualquer pool)
+static thread_local const WorkStealingPool* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+/**
+ * @brief Starts the workers.
+ *
+ * @param threadCount The number of workers; 0 uses one per hardware thread.
+ *
+ * @note Time Complexity: O(t), where t is the number of workers.
+ */
+WorkStealingPool::WorkStealingPool(int threadCount) {
+    if (threadCount <= 0) threadCount = max(1u, thread::hardware_concurrency());
+
+    for (int i = 0; i < threadCount; ++i)
+        queues.push_back(make_unique<WorkerQueue>());
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back([this, i] { run(i); });
+}
+
+/**
+ * @brief Finishes the queued tasks and joins the workers.
+ */
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> lk(wakeLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+/**
+ * @brief Queues a task.
+ *
+ * @param task The task to run.
+ *
+ * @note Time Complexity: O(1).
+ */
+void WorkStealingPool::submit(function<void()> task) {
+    int target = (currentPool == this) ? currentWorker : (int)(nextQueue++ % queues.size());
+    {
+        // Contadores e deque atualizados sob wakeLock: um worker a dormir nunca perde a tarefa
+        lock_guard<mutex> lk(wakeLock);
+        unfinished++;
+        queued++;
+        lock_guard<mutex> qlk(queues[target]->lock);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Blocks until every submitted task has finished.
+ */
+void WorkStealingPool::wait() {
+    unique_lock<mutex> lk(wakeLock);
+    done.wait(lk, [this] { return unfinished == 0; });
+}
+
+/**
+ * @brief Takes the newest task of a worker's own deque.
+ *
+ * @note Time Complexity: O(1).
+ */
+bool WorkStealingPool::tryPop(int worker, function<void()>& task) {
+    WorkerQueue& q = *queues[worker];
+    lock_guard<mutex> lk(q.lock);
+    if (q.tasks.empty()) return false;
+    task = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    return true;
+}
+
+/**
+ * @brief Takes the oldest task of some other worker's deque.
+ *
+ * @note Time Complexity: O(t), where t is the number of workers.
+ */
+bool WorkStealingPool::trySteal(int worker, function<void()>& task) {
+    int n = (int)queues.size();
+    for (int k = 1; k < n; ++k) {
+        WorkerQueue& q = *queues[(worker + k) % n];
+        lock_guard<mutex> lk(q.lock);
+        if (q.tasks.empty()) continue;
+        task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Main loop of a worker: run own tasks, steal when idle, sleep when there is nothing to do.
+ */
+void WorkStealingPool::run(int worker) {
+    currentPool = this;
+    currentWorker = worker;
+
+    while (true) {
+        function<void()> task;
+        if (tryPop(worker, task) || trySteal(worker, task)) {
+            queued--;
+            task();
+            if (--unfinished == 0) {
+                lock_guard<mutex> lk(wakeLock);
+                done.notify_all();
+            }
+            continue;
+        }
+
+        unique_lock<mutex> lk(wakeLock);
+        wake.wait(lk, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
+
+/**
+ * @brief Runs `body(begin, end)` over [0, count) in pieces of at most `grain` items, in parallel.
+ *
+ * @param pool The pool that runs the pieces.
+ * @param count The number of items.
+ * @param grain The maximum number of items per task.
+ * @param body The work for a range of items.
+ *
+ * @note Time Complexity: O(count / grain) tasks, plus the work itself.
+ */
+void parallelFor(WorkStealingPool& pool, size_t count, size_t grain, const function<void(size_t, size_t)>& body) {
+    grain = max<size_t>(grain, 1);
+    for (size_t begin = 0; begin < count; begin += grain) {
+        size_t end = min(count, begin + grain);
+        pool.submit([&body, begin, end] { body(begin, end); });
+    }
+    pool.wait();
+}
+
+/**
+ * @brief Replaces every value by its inclusive prefix sum, in parallel.
+ *
+ * @param pool The pool that runs the blocks.
+ * @param values The values; receives their inclusive prefix sums.
+ *
+ * @note Time Complexity: O(n / t + t), where t is the number of workers.
+ */
+void parallelPrefixSum(WorkStealingPool& pool, vector<int>& values) {
+    size_t n = values.size();
+    size_t blocks = (size_t)pool.size() * 4;
+    if (n < (size_t(1) << 16) || blocks < 2) {
+        for (size_t i = 1; i < n; ++i) values[i] += values[i - 1];
+        return;
+    }
+
+    // 1.ª passagem: total de cada bloco
+    size_t blockSize = (n + blocks - 1) / blocks;
+    vector<int> totals(blocks, 0);
+    parallelFor(pool, blocks, 1, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b) {
+            size_t end = min(n, (b + 1) * blockSize);
+            int sum = 0;
+            for (size_t i = b * blockSize; i < end; ++i) sum += values[i];
+            totals[b] = sum;
+        }
+    });
+
+    // Soma exclusiva dos totais: o valor inicial de cada bloco
+    int running = 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        int total = totals[b];
+        totals[b] = running;
+        running += total;
+    }
+
+    // 2.ª passagem: cada bloco faz a sua soma a partir do valor inicial
+    parallelFor(pool, blocks, 1, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b) {
+            size_t end = min(n, (b + 1) * blockSize);
+            int sum = totals[b];
+            for (size_t i = b * blockSize; i < end; ++i) values[i] = sum += values[i];
+        }
+    });
+}
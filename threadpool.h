@@ -0,0 +1,110 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed-size thread pool with one task deque per worker and work stealing.
+ *
+ * A worker runs the most recently queued task of its own deque (LIFO, good locality) and,
+ * when that is empty, steals the oldest task of another worker (FIFO, large pieces of work).
+ * Tasks submitted from outside the pool are spread round-robin over the deques.
+ *
+ * Every worker is a separate thread, so the per-thread search state (`threadQueryContext`,
+ * the Dijkstra queues) is never shared between concurrent tasks.
+ */
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<WorkerQueue>> queues;
+    vector<thread> threads;
+
+    mutex wakeLock;                   // protege a espera dos workers e de wait()
+    condition_variable wake;          // há tarefas novas ou o pool vai terminar
+    condition_variable done;          // todas as tarefas terminaram
+    atomic<int> queued{0};            // tarefas à espera numa deque
+    atomic<int> unfinished{0};        // tarefas submetidas e ainda não terminadas
+    atomic<unsigned> nextQueue{0};
+    bool stopping = false;
+
+    bool tryPop(int worker, function<void()>& task);
+    bool trySteal(int worker, function<void()>& task);
+    void run(int worker);
+
+public:
+    /**
+     * @brief Starts the workers.
+     *
+     * @param threadCount The number of workers; 0 uses one per hardware thread.
+     */
+    explicit WorkStealingPool(int threadCount = 0);
+
+    /**
+     * @brief Finishes the queued tasks and joins the workers.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Returns the number of workers.
+     */
+    int size() const { return (int)threads.size(); }
+
+    /**
+     * @brief Queues a task. Called from a worker, the task goes to that worker's own deque.
+     *
+     * @note Time Complexity: O(1).
+     */
+    void submit(function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished. Must not be called from a worker.
+     */
+    void wait();
+};
+
+/**
+ * @brief Runs `body(begin, end)` over [0, count) in pieces of at most `grain` items, in parallel.
+ *
+ * Returns once every piece has finished.
+ *
+ * @param pool The pool that runs the pieces.
+ * @param count The number of items.
+ * @param grain The maximum number of items per task (at least 1).
+ * @param body The work for a range of items; it must be safe to run concurrently on disjoint ranges.
+ *
+ * @note Time Complexity: O(count / grain) tasks, plus the work itself.
+ */
+void parallelFor(WorkStealingPool& pool, size_t count, size_t grain, const function<void(size_t, size_t)>& body);
+
+/**
+ * @brief Replaces every value by the sum of itself and all the values before it, in parallel.
+ *
+ * The values are split into one block per task: the blocks are summed in parallel, the block
+ * totals are scanned on the calling thread, and each block is then scanned in parallel
+ * starting from the total of the blocks before it. Short arrays are scanned serially.
+ *
+ * @param pool The pool that runs the blocks.
+ * @param values The values; receives their inclusive prefix sums.
+ *
+ * @note Time Complexity: O(n / t + t), where t is the number of workers.
+ */
+void parallelPrefixSum(WorkStealingPool& pool, vector<int>& values);
+
+#endif
@@ -0,0 +1,81 @@
+#include "updates.h"
+#include <memory>
+#include <algorithm>
+
+/**
+ * @brief Compares two driving times where -1 (undrivable) is infinite.
+ *
+ * @return True if `next` is shorter than `previous`.
+ */
+static bool drivingShorter(int next, int previous) {
+    if (next == -1) return false;
+    return previous == -1 || next < previous;
+}
+
+/**
+ * @brief Applies travel time updates to a network without rebuilding it.
+ *
+ * @param net The network.
+ * @param updates The new times, as edges between node IDs.
+ * @return What was changed.
+ *
+ * @note Time Complexity: O(u * d) for the graph, plus the recustomized part of the CCH, where u is the number of updates and d the degree.
+ */
+WeightUpdateStats applyWeightUpdates(Network& net, const vector<Edge>& updates) {
+    WeightUpdateStats stats;
+    Graph& g = net.graph;
+    int n = g.nodeCount();
+    vector<pair<int, int>> drivingChanged;   // segmentos cujo tempo de condução mudou
+
+    for (const Edge& update : updates) {
+        if (update.from < 0 || update.to < 0 || update.from >= n || update.to >= n) {
+            stats.missingSegments++;
+            continue;
+        }
+
+        // Todos os arcos entre os dois nós, nos dois sentidos
+        EdgeData next = {update.drivingTime, update.walkingTime};
+        bool found = false, changed = false, drivingChange = false;
+        for (int end : {update.from, update.to}) {
+            int other = end == update.from ? update.to : update.from;
+            for (int e = g.firstEdge(end); e < g.lastEdge(end); ++e) {
+                if (g.target(e) != other) continue;
+                found = true;
+                const EdgeData& previous = g.edgeData(e);
+                if (previous.drivingTime == next.drivingTime && previous.walkingTime == next.walkingTime) continue;
+                if (previous.drivingTime != next.drivingTime) {
+                    drivingChange = true;
+                    stats.drivingDecreased = stats.drivingDecreased || drivingShorter(next.drivingTime, previous.drivingTime);
+                }
+                g.setEdgeData(e, next);
+                changed = true;
+            }
+            if (update.from == update.to) break;   // lacete: os arcos já foram todos vistos
+        }
+
+        if (!found) stats.missingSegments++;
+        if (changed) stats.changedSegments++;
+        if (drivingChange) drivingChanged.push_back({update.from, update.to});
+    }
+    if (drivingChanged.empty()) return stats;
+
+    // ALT: as distâncias antigas só continuam a ser limites inferiores se nenhum tempo diminuiu
+    if (stats.drivingDecreased && net.landmarks) {
+        net.landmarks = nullptr;
+        stats.landmarksDropped = true;
+    }
+
+    // CH estática: os atalhos dependem das pesquisas de testemunhas feitas com os tempos antigos
+    if (net.ch) {
+        net.ch = nullptr;
+        stats.chDropped = true;
+    }
+
+    // CCH: só os arcos que dependem dos segmentos alterados (a métrica partilhada é copiada)
+    if (net.cch && net.cchMetric) {
+        auto metric = make_shared<CchMetric>(*net.cchMetric);
+        stats.cchArcsChanged = recustomizeCch(*net.cch, g, *metric, drivingChanged);
+        net.cchMetric = std::move(metric);
+    }
+    return stats;
+}
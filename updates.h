@@ -0,0 +1,45 @@
+#ifndef UPDATES_HPP
+#define UPDATES_HPP
+
+#include <vector>
+#include "parser.h"
+#include "network.h"
+
+/**
+ * @struct WeightUpdateStats
+ * @brief What `applyWeightUpdates` changed in a network.
+ */
+struct WeightUpdateStats {
+    int changedSegments = 0;      // segmentos com tempos diferentes dos anteriores
+    int missingSegments = 0;      // atualizações de segmentos que não existem no grafo
+    bool drivingDecreased = false;
+    bool landmarksDropped = false;
+    bool chDropped = false;
+    int cchArcsChanged = 0;       // arcos da CCH cujo peso customizado mudou
+};
+
+/**
+ * @brief Applies travel time updates to a network without rebuilding it.
+ *
+ * Every update sets the driving and walking times of all the arcs between its two nodes (both
+ * directions, and every parallel segment), patching the CSR weights in place. The preprocessing
+ * is then kept consistent with the new times, doing only the work the change requires:
+ * - ALT: the landmark distances stay valid lower bounds while driving times only increase
+ *   (or a segment becomes undrivable); after any decrease the table is dropped.
+ * - CH: its shortcuts come from witness searches on the old times and cannot be repaired
+ *   locally, so any driving change drops it; the CH engine then answers with the CCH (or
+ *   Dijkstra when there is none).
+ * - CCH: the topology is independent of the times; the metric is recustomized only on the
+ *   arcs that depend on the changed segments (`recustomizeCch`).
+ * Walking times have no preprocessing. Updates of segments that do not exist are counted and
+ * ignored: the structure of the graph never changes.
+ *
+ * @param net The network; its graph and preprocessing pointers are modified (shared preprocessing is copied, not changed).
+ * @param updates The new times, as edges between node IDs (see `parseWeightUpdates`).
+ * @return What was changed.
+ *
+ * @note Time Complexity: O(u * d) for the graph, plus the recustomized part of the CCH, where u is the number of updates and d the degree.
+ */
+WeightUpdateStats applyWeightUpdates(Network& net, const vector<Edge>& updates);
+
+#endif
@@ -0,0 +1,73 @@
+#include "writer.h"
+#include <cstring>
+
+/**
+ * @brief Opens a file for writing ("-" writes to stdout).
+ *
+ * @param path The path of the file.
+ * @param binary True to open the file in binary mode.
+ */
+ResultWriter::ResultWriter(const string& path, bool binary) : buffer(defaultCapacity) {
+    if (path == "-") {
+        file = stdout;
+    } else {
+        file = fopen(path.c_str(), binary ? "wb" : "w");
+        ownsFile = true;
+    }
+}
+
+/**
+ * @brief Writes to an already open stream, which is not closed.
+ *
+ * @param stream The stream.
+ */
+ResultWriter::ResultWriter(FILE* stream) : file(stream), buffer(defaultCapacity) {}
+
+/**
+ * @brief Collects the output in memory.
+ */
+ResultWriter::ResultWriter() : inMemory(true), buffer(4096) {}
+
+/**
+ * @brief Flushes the buffer and closes the file if the writer opened it.
+ */
+ResultWriter::~ResultWriter() {
+    flush();
+    if (ownsFile && file) fclose(file);
+}
+
+/**
+ * @brief Hands the buffered bytes to the stream and flushes it.
+ *
+ * @return False if a write failed.
+ *
+ * @note Time Complexity: O(n), where n is the number of buffered bytes.
+ */
+bool ResultWriter::flush() {
+    if (inMemory) return !failed;   // o conteúdo fica no buffer
+    if (file && used > 0 && fwrite(buffer.data(), 1, used, file) != used) failed = true;
+    used = 0;   // sem destino, os dados são descartados
+    if (!file) return false;
+    if (fflush(file) != 0) failed = true;
+    return !failed;
+}
+
+/**
+ * @brief Appends raw bytes.
+ *
+ * @param data The bytes.
+ * @param size The number of bytes.
+ *
+ * @note Time Complexity: O(n), where n is the number of bytes.
+ */
+void ResultWriter::write(const char* data, size_t size) {
+    if (size > buffer.size() && !inMemory) {
+        // Blocos maiores do que o buffer vão diretamente para o ficheiro
+        flush();
+        if (file && fwrite(data, 1, size, file) != size) failed = true;
+        return;
+    }
+    reserve(size);
+    memcpy(buffer.data() + used, data, size);
+    used += size;
+}
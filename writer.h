@@ -0,0 +1,129 @@
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <type_traits>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @class ResultWriter
+ * @brief Buffered output for batch results.
+ *
+ * Text and integers are formatted straight into a large reusable buffer (integers with
+ * `to_chars`, no locale or stream state) and handed to the C stream in big blocks, so writing
+ * millions of result lines costs one `fwrite` per block instead of one stream call per token.
+ * It writes to a file, to stdout ("-") or to any already open stream such as a pipe, or
+ * collects the output in memory.
+ */
+class ResultWriter {
+private:
+    FILE* file = nullptr;
+    bool ownsFile = false;      // fecha o ficheiro no destrutor
+    bool inMemory = false;      // sem ficheiro: o buffer cresce e guarda tudo
+    bool failed = false;
+    vector<char> buffer;
+    size_t used = 0;
+
+    void reserve(size_t bytes) {
+        if (used + bytes <= buffer.size()) return;
+        if (inMemory) {
+            buffer.resize(max(buffer.size() * 2, used + bytes));
+            return;
+        }
+        flush();
+        if (bytes > buffer.size()) buffer.resize(bytes);
+    }
+
+public:
+    static const size_t defaultCapacity = 1 << 20;
+
+    /**
+     * @brief Opens a file for writing ("-" writes to stdout).
+     *
+     * @param path The path of the file.
+     * @param binary True to open the file in binary mode.
+     */
+    explicit ResultWriter(const string& path, bool binary = false);
+
+    /**
+     * @brief Writes to an already open stream (stdout, a pipe from `popen`...), which is not closed.
+     */
+    explicit ResultWriter(FILE* stream);
+
+    /**
+     * @brief Collects the output in memory instead of writing it (see `text` and `clear`).
+     */
+    ResultWriter();
+
+    /**
+     * @brief Flushes the buffer and closes the file if the writer opened it.
+     */
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    /**
+     * @brief Returns whether the destination is open and no write has failed.
+     */
+    bool good() const { return (file != nullptr || inMemory) && !failed; }
+
+    /**
+     * @brief Returns the output collected by an in-memory writer.
+     */
+    string_view text() const { return string_view(buffer.data(), used); }
+
+    /**
+     * @brief Discards the output collected by an in-memory writer, keeping its capacity.
+     */
+    void clear() { used = 0; }
+
+    /**
+     * @brief Hands the buffered bytes to the stream and flushes it.
+     *
+     * @return False if a write failed.
+     */
+    bool flush();
+
+    /**
+     * @brief Appends raw bytes.
+     *
+     * @note Time Complexity: O(n), where n is the number of bytes.
+     */
+    void write(const char* data, size_t size);
+
+    ResultWriter& operator<<(string_view text) {
+        write(text.data(), text.size());
+        return *this;
+    }
+
+    ResultWriter& operator<<(const char* text) { return *this << string_view(text); }
+
+    ResultWriter& operator<<(const string& text) { return *this << string_view(text); }
+
+    ResultWriter& operator<<(char c) {
+        reserve(1);
+        buffer[used++] = c;
+        return *this;
+    }
+
+    /**
+     * @brief Appends an integer in decimal, formatted with `to_chars`.
+     */
+    template <class T, enable_if_t<is_integral_v<T> && !is_same_v<T, char> && !is_same_v<T, bool>, int> = 0>
+    ResultWriter& operator<<(T value) {
+        reserve(24);
+        auto [end, ec] = to_chars(buffer.data() + used, buffer.data() + buffer.size(), value);
+        (void)ec;   // 24 bytes chegam para qualquer inteiro de 64 bits
+        used = end - buffer.data();
+        return *this;
+    }
+};
+
+#endif